@@ -14,6 +14,9 @@
 #include "dnx.h"
 #include "pmc.h"
 #include "pwrseq_utils.h"
+#ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
+#include "smchost_commands.h"
+#endif
 LOG_MODULE_REGISTER(dnx_assisted, CONFIG_DNX_LOG_LEVEL);
 
 static bool pending_restart;
@@ -39,6 +42,21 @@ void dnx_ec_assisted_init(void)
 	pending_restart = false;
 }
 
+#ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
+/* Set DnX strap and trigger cold restart, requires eSPI OOB support */
+static void dnx_smc_trigger(void)
+{
+	dnx_soc_handshake();
+	dnx_ec_assisted_restart();
+}
+
+SMCHOST_CMD_DEFINE(SMCHOST_DNX_TRIGGER, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   dnx_smc_trigger);
+/* Set DnX strap only, requires manual restart */
+SMCHOST_CMD_DEFINE(SMCHOST_DNX_SET_STRAP, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   dnx_soc_handshake);
+#endif /* CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC */
+
 void dnx_ec_assisted_manage(void)
 {
 	LOG_INF("%s pending:%d", __func__, pending_restart);
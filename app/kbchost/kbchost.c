@@ -4,14 +4,18 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/espi.h>
+#include <zephyr/shell/shell.h>
 #include "kbchost.h"
+#include "kbchost_latency.h"
 #include "ps2kbaux.h"
 #include "gpio_ec.h"
 #include "espi_hub.h"
 #include "kbs_matrix.h"
 #include "pwrplane.h"
+#include "smc.h"
 #include "board_config.h"
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
@@ -44,28 +48,110 @@ struct host_byte {
 	uint8_t cmd;
 };
 
-#define TO_HOST_LEN	16U
 #define MAX_TO_HOST_RETRIES 3U
 #define MAX_RST_ATTEMPTS 3U
 /* Period unit in ms */
 #define MB_RESET_PERIOD 8U
 #define KBC_RETRY_PERIOD 1U
 #define TOHOST_RETRY_PERIOD 2U
+#ifdef CONFIG_KBCHOST_OBE_EVENT
+#define TOHOST_OBE_TIMEOUT 20U
+#else
+#define TOHOST_OBE_TIMEOUT TOHOST_RETRY_PERIOD
+#endif
 #define GAP_FOR_DUMMY_COMMANDS 5U
 
 K_MSGQ_DEFINE(from_host_queue, sizeof(struct host_byte), 8, 4);
-K_MSGQ_DEFINE(to_host_kb_queue, sizeof(uint8_t), TO_HOST_LEN, 4);
 K_SEM_DEFINE(kb_p60_sem, 0, 1);
+/* Host read port 0x60, given on 8042 output buffer empty events */
+K_SEM_DEFINE(kb_obe_sem, 0, 1);
 K_MUTEX_DEFINE(led_mutex);
 #ifdef CONFIG_PS2_MOUSE
 static atomic_t ps2_reset;
 #endif
 static int kbc_init(void);
 static void purge_kb_queue(void);
-static void send_kb_to_host(uint8_t data);
+static uint8_t kb_ring_get(uint8_t *seq, struct kb_lat_trace *lat,
+			   bool *brk);
+static uint32_t kb_ring_flush(void);
+static bool kb_ring_serve_purge(void);
+static void send_kb_to_host(const uint8_t *data, uint8_t len,
+			    uint32_t event, bool brk);
+#ifdef CONFIG_PS2_MOUSE
+static void mb_queue_put(const uint8_t *pkt, uint8_t len, bool coalesce);
+static uint8_t mb_queue_get(uint8_t *pkt);
+static uint32_t mb_queue_purge(void);
+#endif
 
 static uint8_t current_scan_code = 2;
 
+/* Longest scancode sequence, set 2 pause make code */
+#define KB_SEQ_MAX		8U
+#define KB_RING_MASK		(CONFIG_KBCHOST_KB_RING_SIZE - 1U)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_KBCHOST_KB_RING_SIZE),
+	     "Keyboard ring size must be a power of two");
+BUILD_ASSERT(CONFIG_KBCHOST_KB_BREAK_RESERVE < CONFIG_KBCHOST_KB_RING_SIZE,
+	     "Keyboard ring has no room left for make codes");
+
+/* Sequence length is kept in the low bits of the entry header */
+#define KB_SEQ_LEN_MASK		0x3FU
+/* Break code, may use the reserved room and is never flushed */
+#define KB_SEQ_BREAK		BIT(6)
+/* Flushed while queued behind a break code, skipped by the consumer */
+#define KB_SEQ_DROPPED		BIT(7)
+
+BUILD_ASSERT(KB_SEQ_MAX <= KB_SEQ_LEN_MASK, "Sequence length overflow");
+
+/* Entry header, latency trace is only kept for latency tracing */
+struct kb_seq_hdr {
+	uint8_t len;
+#ifdef CONFIG_KBCHOST_KB_LATENCY
+	struct kb_lat_trace lat;
+#endif
+} __packed;
+
+/* Keyboard data ring between keyboard callbacks and to_host_kb_thread.
+ * Every entry is a header followed by the whole scancode sequence, so a
+ * sequence is either queued, delivered or dropped as a unit.
+ * Indexes are free running, head is only written by producers and tail
+ * only by to_host_kb_thread.
+ */
+static struct {
+	uint8_t buf[CONFIG_KBCHOST_KB_RING_SIZE];
+	atomic_t head;
+	atomic_t tail;
+	/* Purge requests are served by the consumer up to purge_head */
+	atomic_t purge;
+	atomic_t purge_head;
+	/* Consumer is still writing a sequence to port 0x60 */
+	atomic_t inflight;
+	uint32_t high_water;
+	uint32_t dropped;
+} kb_ring;
+
+/* PS/2 keyboard and scan matrix may both produce data */
+static struct k_spinlock kb_ring_lock;
+
+#ifdef CONFIG_PS2_MOUSE
+#define MB_QUEUE_SIZE		4U
+
+/* Mouse packets and command responses waiting for port 0x60, also
+ * protected by kb_ring_lock. While the host is slow the newest packet
+ * absorbs further movement, so the queue only grows on button changes.
+ */
+static struct {
+	uint8_t pkt[MB_QUEUE_SIZE][PS2_MB_PKT_MAX];
+	uint8_t len[MB_QUEUE_SIZE];
+	/* Entry is a movement packet that may absorb further movement */
+	bool coalesce[MB_QUEUE_SIZE];
+	uint8_t head;
+	uint8_t count;
+	uint32_t coalesced;
+	uint32_t dropped;
+} mb_queue;
+#endif
+
 static enum {
 	DEFAULT_STATE = 0,
 	WRITE_CMD_BYTE_STATE,
@@ -265,9 +351,8 @@ static int process_keyboard_data(uint8_t data, uint8_t *output)
 
 		if (data & KBC_8042_MOUSE_DIS) {
 			cmdbyte_disable_mb();
-
 		} else {
-			cmdbyte_disable_mb();
+			cmdbyte_enable_mb();
 		}
 
 		data_port_state = DEFAULT_STATE;
@@ -285,7 +370,12 @@ static int process_keyboard_data(uint8_t data, uint8_t *output)
 		data_port_state = DEFAULT_STATE;
 		break;
 	case ECHO_MOUSE_STATE:
-#if defined(CONFIG_PS2_KEYBOARD) || defined(CONFIG_PS2_MOUSE)
+#if defined(CONFIG_PS2_MOUSE)
+		/* Echo sends back data to host through aux register, behind
+		 * mouse data already queued.
+		 */
+		mb_queue_put(&data, 1, false);
+#elif defined(CONFIG_PS2_KEYBOARD)
 		/* Echo sends back data to host through aux register */
 		espihub_kbc_write(E8042_WRITE_MB_CHAR, data);
 #endif
@@ -293,6 +383,11 @@ static int process_keyboard_data(uint8_t data, uint8_t *output)
 		break;
 	case SEND_TO_MOUSE_STATE:
 #ifdef CONFIG_PS2_MOUSE
+		/* Mouse drops pending packets once it gets a command, purge
+		 * them before the write so its response is never dropped.
+		 */
+		mb_queue_purge();
+
 		if (data == KBC_8042_RESET) {
 			atomic_set(&ps2_reset, 1U);
 			int attempt = 0;
@@ -313,7 +408,6 @@ static int process_keyboard_data(uint8_t data, uint8_t *output)
 		} else {
 			ps2_mouse_write(data);
 		}
-
 #endif
 		data_port_state = DEFAULT_STATE;
 		break;
@@ -390,7 +484,7 @@ static int process_keyboard_data(uint8_t data, uint8_t *output)
 #if defined(CONFIG_PS2_KEYBOARD)
 			ps2_keyboard_write(data);
 #endif
-			output[out_len] = KBC_8042_ACK;
+			output[out_len++] = KBC_8042_ACK;
 			break;
 		case KBC_8042_DEFAULT_DIS:
 			/* Set default and disable */
@@ -510,10 +604,9 @@ static void handle_from_to_host(struct host_byte host_data)
 
 		/* Data is placed in the kb queue in case host is busy */
 		if (unlikely(obf_retries == MAX_RST_ATTEMPTS)) {
-			while (i < out_len) {
-				send_kb_to_host(*(data_to_host + i));
-				i++;
-			}
+			/* Host waits for the response, same as a break */
+			send_kb_to_host(data_to_host + i, out_len - i, 0,
+					true);
 		}
 	}
 }
@@ -535,57 +628,150 @@ void to_from_host_thread(void *p1, void *p2, void *p3)
 	}
 }
 
+/* Next sequence for port 0x60, aux is set for mouse packets. Mouse packets
+ * and keyboard sequences take turns when both are pending, aux tells which
+ * one was sent last. brk is set for keyboard break codes.
+ */
+static uint8_t to_host_next(uint8_t *seq, struct kb_lat_trace *lat,
+			    bool *aux, bool *brk)
+{
+	uint8_t len;
+
+#ifdef CONFIG_PS2_MOUSE
+	bool mb_first = !*aux;
+
+	lat->event = 0;
+	*brk = false;
+	if (mb_first) {
+		len = mb_queue_get(seq);
+		if (len) {
+			*aux = true;
+			return len;
+		}
+	}
+#endif
+
+	*aux = false;
+	len = kb_ring_get(seq, lat, brk);
+
+#ifdef CONFIG_PS2_MOUSE
+	if (!len && !mb_first) {
+		len = mb_queue_get(seq);
+		*aux = len != 0;
+	}
+#endif
+
+	return len;
+}
+
+/* Drop queued keyboard and mouse data, returns the amount dropped. Break
+ * codes are kept, host would see held keys otherwise.
+ */
+static uint32_t to_host_flush(void)
+{
+	uint32_t count = kb_ring_flush();
+
+#ifdef CONFIG_PS2_MOUSE
+	count += mb_queue_purge();
+#endif
+
+	return count;
+}
+
 void to_host_kb_thread(void *p1, void *p2, void *p3)
 {
-	uint32_t kb_data;
+	uint8_t seq[KB_SEQ_MAX];
+	uint8_t seq_len = 0;
+	uint8_t idx = 0;
+	struct kb_lat_trace seq_lat = { 0 };
 	uint32_t host_char;
 	uint8_t obf_retries = 0;
+	bool aux = false;
+	bool brk = false;
 
 	while (true) {
 		k_sem_take(&kb_p60_sem, K_FOREVER);
 		while (true) {
-
-			/* Process the keyboard queue. If the amount of
-			 * retries is exceeded due to a storm of keys, then
-			 * Windows is going to show keys presed in past
-			 * keystrokes because it couldn't empty its queue.
-			 * This is why it is better to purge the kb queue
-			 * and let user see keys as pressed
+			/* Host requested purge also drops the partially
+			 * sent sequence, host is resetting the keyboard.
+			 * Mouse packets are always sent whole.
 			 */
-			if (k_msgq_num_used_get(&to_host_kb_queue) != 0U) {
-				espihub_kbc_read(E8042_OBF_HAS_CHAR,
-						 &host_char);
-				if (host_char) {
-					/* If the host is polling, then it is
-					 * highly probable that this retry
-					 * code is going to be exercised.
-					 */
-					if (obf_retries++  >
-					    MAX_TO_HOST_RETRIES) {
-						purge_kb_queue();
-						obf_retries = 0;
-						break;
+			if (kb_ring_serve_purge() && !aux) {
+				idx = seq_len;
+			}
 
+			if (idx == seq_len) {
+				seq_len = to_host_next(seq, &seq_lat, &aux,
+						       &brk);
+				idx = 0;
+				atomic_set(&kb_ring.inflight,
+					   seq_len != 0 && !aux);
+			}
+
+			/* Go to suspended state if kb queue is empty */
+			if (!seq_len) {
+				break;
+			}
+
+			espihub_kbc_read(E8042_OBF_HAS_CHAR, &host_char);
+			if (host_char) {
+				/* Next byte is sent as soon as the host reads
+				 * the previous one. The short default timeout
+				 * covers eSPI drivers not reporting OBE events.
+				 */
+				uint32_t wait_start = kb_lat_now();
+				int ret;
+
+				ret = k_sem_take(&kb_obe_sem,
+						 K_MSEC(TOHOST_OBE_TIMEOUT));
+
+				kb_lat_host_wait(kb_lat_now() - wait_start);
+				if (!ret) {
+					continue;
+				}
+
+				/* If the host is polling, then it is highly
+				 * probable that this retry code is going to
+				 * be exercised. If the amount of retries is
+				 * exceeded due to a storm of keys, then
+				 * Windows is going to show keys pressed in
+				 * past keystrokes because it couldn't empty
+				 * its queue. This is why it is better to drop
+				 * the queued sequences and let user see keys
+				 * as pressed. The sequence in progress is
+				 * dropped too if none of its bytes was sent,
+				 * otherwise it is retried until complete so
+				 * host never gets a partial make/break code.
+				 * Break codes are never dropped so no key
+				 * stays pressed.
+				 */
+				if (obf_retries++ > MAX_TO_HOST_RETRIES) {
+					to_host_flush();
+					if (!idx && !brk) {
+						idx = seq_len;
 					}
-					k_msleep(TOHOST_RETRY_PERIOD);
-				} else {
-					/* Wake the Host if system is in S3 on
-					 * detection of first key press.
-					 */
-					if (pwrseq_system_state() == SYSTEM_S3_STATE) {
-						smc_generate_wake(WAKE_KBC_EVENT);
-					}
-					/* Send more kb data to the host */
-					k_msgq_get(&to_host_kb_queue,
-						   &kb_data, K_NO_WAIT);
-					espihub_kbc_write(E8042_WRITE_KB_CHAR,
-							  kb_data);
-					LOG_DBG("kb data: %x", kb_data);
 					obf_retries = 0;
 				}
 			} else {
-				/* Go to suspended state if kb queue is empty */
-				break;
+				/* Wake the Host if system is in S3 on
+				 * detection of first key press.
+				 */
+				if (pwrseq_system_state() == SYSTEM_S3_STATE) {
+					smc_generate_wake(WAKE_KBC_EVENT);
+				}
+				/* Send more kb data to the host, stale OBE
+				 * events don't refer to this byte.
+				 */
+				k_sem_reset(&kb_obe_sem);
+				espihub_kbc_write(aux ? E8042_WRITE_MB_CHAR :
+						  E8042_WRITE_KB_CHAR,
+						  seq[idx]);
+				LOG_DBG("%s data: %x", aux ? "mb" : "kb",
+					seq[idx]);
+				if (++idx == seq_len) {
+					kb_lat_sequence(&seq_lat);
+				}
+				obf_retries = 0;
 			}
 		}
 	}
@@ -593,7 +779,7 @@ void to_host_kb_thread(void *p1, void *p2, void *p3)
 
 #if defined(CONFIG_PS2_KEYBOARD)
 /* Callback passed to the PS2 instance handling the keyboard */
-static void keyboard_callback(uint8_t data)
+static void keyboard_callback(uint8_t data, uint32_t event)
 {
 
 	/* We return the dummy ACKs when processing the keyboard
@@ -604,12 +790,53 @@ static void keyboard_callback(uint8_t data)
 	 */
 	if (cmdbyte_kbd_enabled() && data != KBC_8042_ACK
 	   && data != KBC_8042_NACK) {
-		send_kb_to_host(data);
+		/* Set 2 break code is the prefix and the key code */
+		static bool brk_prefix;
+		bool brk = brk_prefix || data == KB_BREAK_PREFIX;
+
+		brk_prefix = data == KB_BREAK_PREFIX;
+		send_kb_to_host(&data, 1, event, brk);
 	}
 }
 #endif
 
 #if defined(CONFIG_PS2_MOUSE)
+/* Queue mouse data for port 0x60, movement packets may be merged into the
+ * newest queued one while command responses are always queued as is.
+ */
+static void mb_queue_put(const uint8_t *pkt, uint8_t len, bool coalesce)
+{
+	k_spinlock_key_t key;
+	uint8_t tail;
+
+	key = k_spin_lock(&kb_ring_lock);
+	if (coalesce && mb_queue.count) {
+		tail = (mb_queue.head + mb_queue.count - 1U) % MB_QUEUE_SIZE;
+		if (mb_queue.coalesce[tail] && mb_queue.len[tail] == len &&
+		    ps2_mouse_coalesce(mb_queue.pkt[tail], pkt, len)) {
+			mb_queue.coalesced++;
+			k_spin_unlock(&kb_ring_lock, key);
+			return;
+		}
+	}
+
+	if (mb_queue.count == MB_QUEUE_SIZE) {
+		mb_queue.dropped++;
+		k_spin_unlock(&kb_ring_lock, key);
+		LOG_WRN("mb queue full, drop %x", pkt[0]);
+		return;
+	}
+
+	tail = (mb_queue.head + mb_queue.count) % MB_QUEUE_SIZE;
+	memcpy(mb_queue.pkt[tail], pkt, len);
+	mb_queue.len[tail] = len;
+	mb_queue.coalesce[tail] = coalesce;
+	mb_queue.count++;
+	k_spin_unlock(&kb_ring_lock, key);
+
+	k_sem_give(&kb_p60_sem);
+}
+
 /* Callback passed to the PS2 instance handling the mouse */
 static void mouse_callback(uint8_t data)
 {
@@ -621,32 +848,80 @@ static void mouse_callback(uint8_t data)
 	 * The other scenario is when the mouse is enabled (bit 5 in cmd byte)
 	 * and ready to send mouse data such as x,y coordinates and button
 	 * interaction.
+	 * Bytes go through the mouse queue so they reach the host in order
+	 * with movement packets and never collide with keyboard data.
 	 */
 	if (atomic_get(&ps2_reset) == 1U) {
 		if (data == KBC_8042_ACK) {
 			atomic_set(&ps2_reset, 0U);
 			LOG_WRN("Reset aux: %x", data);
-			espihub_kbc_write(E8042_WRITE_MB_CHAR, data);
+			mb_queue_put(&data, 1, false);
 		}
 	} else {
 		if ((!cmdbyte_mb_enabled() &&
 		     (data == KBC_8042_ACK || data == KBC_8042_NACK))
 			|| cmdbyte_mb_enabled()) {
-			espihub_kbc_write(E8042_WRITE_MB_CHAR, data);
+			mb_queue_put(&data, 1, false);
 		}
 	}
 }
+
+/* Callback passed to the PS2 instance for whole mouse packets */
+static void mouse_packet_callback(const uint8_t *pkt, uint8_t len)
+{
+	if (!cmdbyte_mb_enabled()) {
+		return;
+	}
+
+	mb_queue_put(pkt, len, true);
+}
+
+/* Only called from to_host_kb_thread, returns the packet length */
+static uint8_t mb_queue_get(uint8_t *pkt)
+{
+	k_spinlock_key_t key = k_spin_lock(&kb_ring_lock);
+	uint8_t len = 0;
+
+	if (mb_queue.count) {
+		len = mb_queue.len[mb_queue.head];
+		memcpy(pkt, mb_queue.pkt[mb_queue.head], len);
+		mb_queue.head = (mb_queue.head + 1U) % MB_QUEUE_SIZE;
+		mb_queue.count--;
+	}
+
+	k_spin_unlock(&kb_ring_lock, key);
+
+	return len;
+}
+
+/* Drop all queued mouse packets, returns the amount dropped */
+static uint32_t mb_queue_purge(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&kb_ring_lock);
+	uint32_t count = mb_queue.count;
+
+	mb_queue.count = 0;
+	k_spin_unlock(&kb_ring_lock, key);
+
+	return count;
+}
 #endif
 
 #if defined(CONFIG_KSCAN_EC)
+/* Host hasn't taken all the kb data queued so far */
+static bool kb_queue_busy(void)
+{
+	return atomic_get(&kb_ring.head) != atomic_get(&kb_ring.tail) ||
+	       atomic_get(&kb_ring.inflight);
+}
+
 /* All the kb data is being pushed to kbc host in a single shot */
-static void mtx_keyboard_callback(uint8_t *data, uint8_t len)
+static void mtx_keyboard_callback(const uint8_t *data, uint8_t len,
+				  uint32_t event, bool brk)
 {
 
 	if (cmdbyte_kbd_enabled() && !kbs_is_hotkey_detected()) {
-		for (int i = 0; i < len; i++) {
-			send_kb_to_host(data[i]);
-		}
+		send_kb_to_host(data, len, event, brk);
 	}
 }
 #endif
@@ -657,7 +932,7 @@ static int kbc_init(void)
 	int ps2_mb_err = 0;
 
 #if defined(CONFIG_PS2_MOUSE)
-	ps2_mb_err = ps2_mouse_init(mouse_callback);
+	ps2_mb_err = ps2_mouse_init(mouse_callback, mouse_packet_callback);
 #endif
 
 #if defined(CONFIG_PS2_KEYBOARD)
@@ -679,6 +954,8 @@ static int kbc_init(void)
 	if (mtx_kb_err) {
 		return -ENOTSUP;
 	}
+
+	kbs_matrix_set_busy_callback(kb_queue_busy);
 #endif
 
 	return 0;
@@ -746,6 +1023,12 @@ void kbc_handler(struct espi_evt_data_kbc *kbc_evt)
 	host_data.data = kbc_evt->data;
 	host_data.cmd = kbc_evt->type;
 
+	/* Host drained the output buffer, more kb data can be sent */
+	if (kbc_evt->evt == HOST_KBC_EVT_OBE) {
+		k_sem_give(&kb_obe_sem);
+		return;
+	}
+
 	/* Discard irrelevant events, only KBC IBF events matter.
 	 * Some EC vendors send send HOST_KBC_EVT_IBF and HOST_KBC_EVT_OBE events.
 	 * Meanwhile others send only HOST_KBC_EVT_IBF and do not initialize the evt.evt field
@@ -826,17 +1109,205 @@ int kbc_get_leds(void)
 	return ret;
 }
 
-/* Typically data len will by 1 expect for the cases where we have to
- * fake the keyboard ID for Kscan devices.
+/* Queue a whole scancode sequence, the sequence is dropped if it doesn't
+ * fit so the host never receives a partial make/break code. The key event
+ * timestamp travels with the sequence for latency tracing. Make codes leave
+ * CONFIG_KBCHOST_KB_BREAK_RESERVE bytes free, so the break code of a key
+ * the host saw pressed still fits when the queue is full.
  */
-static void send_kb_to_host(uint8_t data)
+static void send_kb_to_host(const uint8_t *data, uint8_t len,
+			    uint32_t event, bool brk)
 {
-	k_msgq_put(&to_host_kb_queue, &data, K_NO_WAIT);
+	struct kb_seq_hdr hdr = { .len = len | (brk ? KB_SEQ_BREAK : 0) };
+	uint8_t *hdr_bytes = (uint8_t *)&hdr;
+	uint32_t size = sizeof(hdr) + len;
+	uint32_t room = CONFIG_KBCHOST_KB_RING_SIZE;
+	struct kb_lat_trace lat;
+	k_spinlock_key_t key;
+	uint32_t head;
+	uint32_t used;
+
+	if (!len || len > KB_SEQ_MAX) {
+		LOG_ERR("Invalid kb sequence len %d", len);
+		return;
+	}
+
+	if (!brk) {
+		room -= CONFIG_KBCHOST_KB_BREAK_RESERVE;
+	}
+
+	kb_lat_enqueue(&lat, event);
+#ifdef CONFIG_KBCHOST_KB_LATENCY
+	hdr.lat = lat;
+#endif
+
+	key = k_spin_lock(&kb_ring_lock);
+	head = atomic_get(&kb_ring.head);
+	used = head - (uint32_t)atomic_get(&kb_ring.tail);
+	if (used + size > room) {
+		kb_ring.dropped++;
+		k_spin_unlock(&kb_ring_lock, key);
+		LOG_WRN("kb queue full, drop %x", data[0]);
+		return;
+	}
+
+	for (int i = 0; i < sizeof(hdr); i++) {
+		kb_ring.buf[(head + i) & KB_RING_MASK] = hdr_bytes[i];
+	}
+
+	for (int i = 0; i < len; i++) {
+		kb_ring.buf[(head + sizeof(hdr) + i) & KB_RING_MASK] = data[i];
+	}
+
+	/* Publish the sequence only once all bytes are in place */
+	atomic_set(&kb_ring.head, head + size);
+	kb_ring.high_water = MAX(kb_ring.high_water, used + size);
+	k_spin_unlock(&kb_ring_lock, key);
+
 	k_sem_give(&kb_p60_sem);
 }
 
+static void kb_ring_get_hdr(uint32_t tail, struct kb_seq_hdr *hdr)
+{
+	uint8_t *hdr_bytes = (uint8_t *)hdr;
+
+	for (int i = 0; i < sizeof(*hdr); i++) {
+		hdr_bytes[i] = kb_ring.buf[(tail + i) & KB_RING_MASK];
+	}
+}
+
+/* Entries flushed behind a break code are skipped */
+static uint8_t kb_ring_get(uint8_t *seq, struct kb_lat_trace *lat,
+			   bool *brk)
+{
+	uint32_t tail = atomic_get(&kb_ring.tail);
+	struct kb_seq_hdr hdr;
+	uint8_t len;
+
+	do {
+		if (tail == (uint32_t)atomic_get(&kb_ring.head)) {
+			atomic_set(&kb_ring.tail, tail);
+			return 0;
+		}
+
+		kb_ring_get_hdr(tail, &hdr);
+		len = hdr.len & KB_SEQ_LEN_MASK;
+		tail += sizeof(hdr) + len;
+	} while (hdr.len & KB_SEQ_DROPPED);
+
+	for (int i = 0; i < len; i++) {
+		seq[i] = kb_ring.buf[(tail - len + i) & KB_RING_MASK];
+	}
+
+	atomic_set(&kb_ring.tail, tail);
+
+#ifdef CONFIG_KBCHOST_KB_LATENCY
+	*lat = hdr.lat;
+#else
+	lat->event = 0;
+#endif
+	*brk = (hdr.len & KB_SEQ_BREAK) != 0;
+
+	return len;
+}
+
+/* Drop all queued sequences but break codes, returns the amount dropped.
+ * Only the consumer accesses queued entries, producers write past head.
+ */
+static uint32_t kb_ring_flush(void)
+{
+	uint32_t head = atomic_get(&kb_ring.head);
+	uint32_t tail = atomic_get(&kb_ring.tail);
+	struct kb_seq_hdr hdr;
+	uint32_t count = 0;
+	bool kept = false;
+
+	while (tail != head) {
+		kb_ring_get_hdr(tail, &hdr);
+		if (hdr.len & KB_SEQ_BREAK) {
+			kept = true;
+		} else if (!(hdr.len & KB_SEQ_DROPPED)) {
+			/* Room is only given back once no break precedes */
+			kb_ring.buf[tail & KB_RING_MASK] |= KB_SEQ_DROPPED;
+			count++;
+		}
+
+		tail += sizeof(hdr) + (hdr.len & KB_SEQ_LEN_MASK);
+		if (!kept) {
+			atomic_set(&kb_ring.tail, tail);
+		}
+	}
+
+	if (count) {
+		LOG_WRN("Host busy, drop %u kb sequences", count);
+	}
+
+	return count;
+}
+
+/* Drop sequences queued before purge request, newer ones are kept */
+static bool kb_ring_serve_purge(void)
+{
+	uint32_t tail = atomic_get(&kb_ring.tail);
+	uint32_t purge_head;
+
+	if (!atomic_cas(&kb_ring.purge, 1, 0)) {
+		return false;
+	}
+
+	purge_head = atomic_get(&kb_ring.purge_head);
+	if ((int32_t)(purge_head - tail) > 0) {
+		atomic_set(&kb_ring.tail, purge_head);
+	}
+
+	return true;
+}
+
+/* Queue is owned by to_host_kb_thread, purge is deferred to it */
 static void purge_kb_queue(void)
 {
-	k_msgq_purge(&to_host_kb_queue);
+	atomic_set(&kb_ring.purge_head, atomic_get(&kb_ring.head));
+	atomic_set(&kb_ring.purge, 1);
+	k_sem_give(&kb_p60_sem);
+}
+
+void kbc_get_kb_queue_stats(struct kbc_kb_queue_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&kb_ring_lock);
+
+	stats->high_water = kb_ring.high_water;
+	stats->dropped = kb_ring.dropped;
+	stats->used = (uint32_t)atomic_get(&kb_ring.head) -
+		      (uint32_t)atomic_get(&kb_ring.tail);
+#ifdef CONFIG_PS2_MOUSE
+	stats->mb_coalesced = mb_queue.coalesced;
+	stats->mb_dropped = mb_queue.dropped;
+#else
+	stats->mb_coalesced = 0;
+	stats->mb_dropped = 0;
+#endif
+
+	k_spin_unlock(&kb_ring_lock, key);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_queue_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct kbc_kb_queue_stats stats;
+
+	kbc_get_kb_queue_stats(&stats);
+
+	shell_print(sh, "kb used %u high water %u bytes dropped %u",
+		    stats.used, stats.high_water, stats.dropped);
+	shell_print(sh, "mb coalesced %u dropped %u", stats.mb_coalesced,
+		    stats.mb_dropped);
+
+	return 0;
 }
 
+SHELL_SUBCMD_SET_CREATE(sub_kbchost, (kbchost));
+SHELL_SUBCMD_ADD((kbchost), queue, NULL, "Show keyboard and mouse queues",
+		 cmd_queue_stats, 1, 0);
+SHELL_CMD_REGISTER(kbchost, &sub_kbchost, "Keyboard controller commands",
+		   NULL);
+#endif
@@ -51,6 +51,8 @@
 #define KBC_8042_NACK			0xfeU
 #define KBC_8042_BAT			0xaaU
 #define KBC_8042_MOUSE_ID		0U
+/* Scan code set 2 break code prefix */
+#define KB_BREAK_PREFIX			0xf0U
 
 /* Flags for the "command byte" which is located in address 0x20 in ancient
  * KBCs. In the EC case we use a simmple variable for book-keeping.
@@ -139,7 +141,41 @@ void kbc_set_leds(uint8_t leds);
  */
 int kbc_get_leds(void);
 
+/** Keyboard data queue statistics, sizes are in bytes. */
+struct kbc_kb_queue_stats {
+	uint32_t used;
+	uint32_t high_water;
+	uint32_t dropped;
+	/* Mouse packets merged into a queued one or dropped */
+	uint32_t mb_coalesced;
+	uint32_t mb_dropped;
+};
+
+/**
+ * @brief Retrieve keyboard data queue statistics.
+ *
+ * Queue entries hold whole scancode sequences plus one length byte. A
+ * sequence that doesn't fit is dropped as a whole and counted in dropped.
+ *
+ * @param stats pointer to store the statistics.
+ */
+void kbc_get_kb_queue_stats(struct kbc_kb_queue_stats *stats);
+
 void to_from_host_thread(void *p1, void *p2, void *p3);
 void to_host_kb_thread(void *p1, void *p2, void *p3);
 
+#ifdef CONFIG_KBCHOST_BENCH
+/**
+ * @brief 8042 protocol benchmark.
+ *
+ * Replays host 8042 command sequences against the KBC emulator, checks the
+ * responses and logs sequences per second and response latency percentiles.
+ *
+ * @param p1 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ * @param p3 pointer to additional task-specific data.
+ */
+void kbchost_bench_thread(void *p1, void *p2, void *p3);
+#endif
+
 #endif /* __KBCHOST_H__ */
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/espi.h>
+#include <zephyr/logging/log.h>
+#include "bench.h"
+#include "kbc_emul.h"
+#include "kbchost.h"
+
+LOG_MODULE_DECLARE(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
+
+/* Host gives up draining stale bytes after this quiet period */
+#define BENCH_DRAIN_QUIET_US	20000u
+
+#define BENCH_MAX_RESP		3u
+#define BENCH_MAX_STEPS		8u
+
+/* Host write to port 0x64 or 0x60 and the bytes expected on port 0x60 */
+struct bench_step {
+	bool cmd;
+	uint8_t byte;
+	uint8_t len;
+	uint8_t resp[BENCH_MAX_RESP];
+};
+
+struct bench_seq {
+	const char *name;
+	const struct bench_step *steps;
+	size_t count;
+};
+
+#define CMD(b, n, ...)	{ true, b, n, { __VA_ARGS__ } }
+#define DATA(b, n, ...)	{ false, b, n, { __VA_ARGS__ } }
+
+/* Sequences recorded from BIOS and OS i8042 drivers */
+static const struct bench_step seq_self_test[] = {
+	CMD(KBC_8042_RESET_SELF_TEST, 1, TEST_PASSED),
+	CMD(KBC_8042_TEST_KB_PORT, 1, 0x00),
+};
+
+static const struct bench_step seq_cmd_byte[] = {
+	CMD(KBC_8042_WRITE_CMD_BYTE, 0),
+	DATA(0x47, 0),
+	CMD(KBC_8042_READ_CMD_BYTE, 1, 0x47),
+	CMD(KBC_8042_DIS_KB, 0),
+	CMD(KBC_8042_READ_CMD_BYTE, 1, 0x57),
+	CMD(KBC_8042_ENA_KB, 0),
+	CMD(KBC_8042_READ_CMD_BYTE, 1, 0x47),
+};
+
+#ifdef CONFIG_PS2_MOUSE
+static const struct bench_step seq_mouse[] = {
+	CMD(KBC_8042_DIS_MOUSE, 0),
+	CMD(KBC_8042_READ_CMD_BYTE, 1, 0x67),
+	CMD(KBC_8042_ENA_MOUSE, 0),
+	CMD(KBC_8042_READ_CMD_BYTE, 1, 0x47),
+	CMD(KBC_8042_TEST_MOUSE, 1, 0x00),
+};
+#endif
+
+static const struct bench_step seq_leds[] = {
+	DATA(KBC_8042_SET_LEDS, 1, KBC_8042_ACK),
+	DATA(BIT(NUM_LOCK_POS), 1, KBC_8042_ACK),
+};
+
+static const struct bench_step seq_typematic[] = {
+	DATA(KBC_8042_SET_TYPEMATIC_RATE, 1, KBC_8042_ACK),
+	DATA(0x20, 1, KBC_8042_ACK),
+};
+
+static const struct bench_step seq_scancode[] = {
+	DATA(KBC_8042_SET_GET_SCANCODE, 1, KBC_8042_ACK),
+	DATA(0x00, 2, KBC_8042_ACK, KBC_8042_DEFAULT_SCAN_CODE),
+	DATA(KBC_8042_READ_ID, 3, KBC_8042_ACK, 0xab, 0x83),
+};
+
+static const struct bench_step seq_reset[] = {
+	DATA(KBC_8042_RESET, 2, KBC_8042_ACK, KBC_8042_BAT),
+	DATA(KBC_8042_EN_KEYBOARD, 1, KBC_8042_ACK),
+	DATA(KBC_8042_ECHO_KEYBOARD, 1, KBC_8042_ECHO_KEYBOARD),
+	DATA(KBC_8042_RESEND, 1, KBC_8042_ECHO_KEYBOARD),
+};
+
+#define SEQ(n, s)	{ n, s, ARRAY_SIZE(s) }
+
+static const struct bench_seq bench_seqs[] = {
+	SEQ("SELF_TEST", seq_self_test),
+	SEQ("CMD_BYTE", seq_cmd_byte),
+#ifdef CONFIG_PS2_MOUSE
+	SEQ("MOUSE", seq_mouse),
+#endif
+	SEQ("LEDS", seq_leds),
+	SEQ("TYPEMATIC", seq_typematic),
+	SEQ("SCANCODE", seq_scancode),
+	SEQ("RESET", seq_reset),
+};
+
+BUILD_ASSERT(ARRAY_SIZE(seq_cmd_byte) <= BENCH_MAX_STEPS,
+	     "Samples don't fit the longest sequence");
+
+static uint32_t samples[CONFIG_KBCHOST_BENCH_ITERATIONS * BENCH_MAX_STEPS];
+static bool seq_logged;
+
+/* Wait until the status flag reaches the expected value like OS does */
+static int host_wait(uint8_t flag, bool set, uint32_t timeout_us)
+{
+	return bench_wait_sts(kbc_emul_host_read_sts, flag, set, timeout_us);
+}
+
+static int host_write(const struct bench_step *step)
+{
+	if (host_wait(KBC_EMUL_STS_IBF, false, BENCH_TIMEOUT_US)) {
+		return -ETIMEDOUT;
+	}
+
+	return step->cmd ? kbc_emul_host_write_cmd(step->byte) :
+			   kbc_emul_host_write_data(step->byte);
+}
+
+static int host_read(uint8_t *data)
+{
+	if (host_wait(KBC_EMUL_STS_OBF, true, BENCH_TIMEOUT_US)) {
+		return -ETIMEDOUT;
+	}
+
+	return kbc_emul_host_read_data(data);
+}
+
+/* Discard late or unexpected bytes so next sequence starts in sync */
+static void host_drain(void)
+{
+	uint8_t data;
+
+	while (!host_wait(KBC_EMUL_STS_OBF, true, BENCH_DRAIN_QUIET_US)) {
+		kbc_emul_host_read_data(&data);
+		LOG_DBG("Drained %x", data);
+	}
+}
+
+/* Time from the host write until the last response byte is read, or until
+ * the EC consumed the byte when no response is expected.
+ */
+static int bench_step(const struct bench_step *step, uint8_t *got,
+		      uint32_t *cycles)
+{
+	uint32_t start = k_cycle_get_32();
+	int ret;
+
+	ret = host_write(step);
+	if (!ret && !step->len) {
+		ret = host_wait(KBC_EMUL_STS_IBF, false, BENCH_TIMEOUT_US);
+	}
+
+	for (int i = 0; !ret && i < step->len; i++) {
+		ret = host_read(&got[i]);
+		if (!ret && got[i] != step->resp[i]) {
+			ret = -EIO;
+		}
+	}
+
+	*cycles = k_cycle_get_32() - start;
+
+	return ret;
+}
+
+/* Replay a sequence, only the first mismatch of a run is logged */
+static int bench_replay(uint32_t iter, struct bench_samples *lat, void *ctx)
+{
+	const struct bench_seq *seq = ctx;
+	uint8_t got[BENCH_MAX_RESP];
+	uint32_t cycles;
+	int ret;
+
+	if (!iter) {
+		seq_logged = false;
+	}
+
+	for (int i = 0; i < seq->count; i++) {
+		const struct bench_step *step = &seq->steps[i];
+
+		memset(got, 0, sizeof(got));
+		ret = bench_step(step, got, &cycles);
+		if (ret) {
+			if (!seq_logged) {
+				LOG_ERR("%s step %d %s %x: expected %x %x %x "
+					"got %x %x %x (%d)", seq->name, i,
+					step->cmd ? "cmd" : "data", step->byte,
+					step->resp[0], step->resp[1],
+					step->resp[2], got[0], got[1], got[2],
+					ret);
+				seq_logged = true;
+			}
+
+			host_drain();
+			return ret;
+		}
+
+		bench_sample_add(lat, k_cyc_to_us_floor32(cycles));
+	}
+
+	return 0;
+}
+
+/* Returns true if the sequence meets the pass criteria */
+static bool bench_seq_run(const struct bench_seq *seq)
+{
+	struct bench_samples s = {
+		.buf = samples,
+		.size = ARRAY_SIZE(samples),
+	};
+	struct bench_result res;
+
+	bench_run(bench_replay, (void *)seq, CONFIG_KBCHOST_BENCH_ITERATIONS,
+		  &s, &res);
+
+	if (!res.samples) {
+		LOG_ERR("%s: all %u sequences failed", seq->name, res.errors);
+		return false;
+	}
+
+	LOG_INF("%s: %u seq/s step p50 %u us p99 %u us max %u us errors %u",
+		seq->name, res.per_sec, res.p50_us, res.p99_us, res.max_us,
+		res.errors);
+
+	return !res.errors && res.p99_us <= CONFIG_KBCHOST_BENCH_P99_MAX_US;
+}
+
+void kbchost_bench_thread(void *p1, void *p2, void *p3)
+{
+	bool pass = true;
+
+	for (int i = 0; i < ARRAY_SIZE(bench_seqs); i++) {
+		if (!bench_seq_run(&bench_seqs[i])) {
+			LOG_ERR("%s: exceeds p99 %u us or has errors",
+				bench_seqs[i].name,
+				CONFIG_KBCHOST_BENCH_P99_MAX_US);
+			pass = false;
+		}
+	}
+
+	LOG_INF("KBC bench: %s", pass ? "PASS" : "FAIL");
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include "kbchost_latency.h"
+#include "lat_hist.h"
+
+LOG_MODULE_DECLARE(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
+
+struct kb_lat_stats {
+	uint32_t samples;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint16_t hist[KB_LAT_BUCKETS];
+};
+
+static const char * const kb_lat_stage_name[KB_LAT_STAGES] = {
+	"enqueue",
+	"ec",
+	"host",
+	"total",
+};
+
+static struct k_spinlock lat_lock;
+static struct kb_lat_stats lat_stats[KB_LAT_STAGES];
+/* Free running time waited for the host, wraps like cycle counts */
+static atomic_t lat_host_waited;
+
+/* Must be called with lat_lock held */
+static void lat_account(enum kb_lat_stage stage, uint32_t cycles)
+{
+	struct kb_lat_stats *stats = &lat_stats[stage];
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+
+	lat_hist_add(stats->hist, KB_LAT_BUCKETS, us);
+	stats->samples++;
+	stats->sum_us += us;
+	stats->max_us = MAX(stats->max_us, us);
+}
+
+uint32_t kb_lat_key_event(void)
+{
+	/* Zero is reserved for sequences not coming from a key event */
+	return k_cycle_get_32() | 1U;
+}
+
+void kb_lat_enqueue(struct kb_lat_trace *trace, uint32_t event)
+{
+	k_spinlock_key_t key;
+
+	trace->event = event;
+	trace->host_mark = atomic_get(&lat_host_waited);
+	if (!event) {
+		return;
+	}
+
+	key = k_spin_lock(&lat_lock);
+	lat_account(KB_LAT_ENQUEUE, k_cycle_get_32() - event);
+	k_spin_unlock(&lat_lock, key);
+}
+
+void kb_lat_host_wait(uint32_t cycles)
+{
+	atomic_add(&lat_host_waited, cycles);
+}
+
+void kb_lat_sequence(const struct kb_lat_trace *trace)
+{
+	uint32_t total = k_cycle_get_32() - trace->event;
+	uint32_t host_wait;
+	k_spinlock_key_t key;
+
+	if (!trace->event) {
+		return;
+	}
+
+	/* Host kept every sequence queued ahead waiting as well */
+	host_wait = (uint32_t)atomic_get(&lat_host_waited) - trace->host_mark;
+
+	key = k_spin_lock(&lat_lock);
+	lat_account(KB_LAT_EC, total - MIN(host_wait, total));
+	lat_account(KB_LAT_HOST, host_wait);
+	lat_account(KB_LAT_TOTAL, total);
+	k_spin_unlock(&lat_lock, key);
+}
+
+#ifdef CONFIG_SHELL
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
+{
+	struct kb_lat_stats stats;
+	k_spinlock_key_t key;
+
+	for (int i = 0; i < KB_LAT_STAGES; i++) {
+		key = k_spin_lock(&lat_lock);
+		stats = lat_stats[i];
+		k_spin_unlock(&lat_lock, key);
+
+		shell_print(sh, "%s: samples %u avg %u us max %u us",
+			    kb_lat_stage_name[i], stats.samples,
+			    stats.samples ?
+			    (uint32_t)(stats.sum_us / stats.samples) : 0,
+			    stats.max_us);
+		lat_hist_print(sh, stats.hist, KB_LAT_BUCKETS);
+	}
+
+	return 0;
+}
+
+static int cmd_latency_clear(const struct shell *sh, size_t argc,
+			     char **argv)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+	memset(lat_stats, 0, sizeof(lat_stats));
+
+	k_spin_unlock(&lat_lock, key);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_kb_latency,
+	SHELL_CMD(show, NULL, "Show keystroke latency", cmd_latency_show),
+	SHELL_CMD(clear, NULL, "Clear keystroke latency", cmd_latency_clear),
+	SHELL_SUBCMD_SET_END
+);
+
+/* Added to kbchost command registered by kbchost.c */
+SHELL_SUBCMD_ADD((kbchost), latency, &sub_kb_latency, "Keystroke latency",
+		 NULL, 0, 0);
+#endif
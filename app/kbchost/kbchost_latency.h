@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief APIs to trace keystroke latency from key event to host.
+ */
+
+#ifndef __KBCHOST_LATENCY_H__
+#define __KBCHOST_LATENCY_H__
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+/* Latency of a scancode sequence measured from the key event */
+enum kb_lat_stage {
+	/* Key event until the sequence is queued */
+	KB_LAT_ENQUEUE,
+	/* Total latency minus time waiting for the host to read port 0x60 */
+	KB_LAT_EC,
+	/* Time waiting for the host to read port 0x60 since the sequence was
+	 * queued, including waits for sequences queued ahead of it.
+	 */
+	KB_LAT_HOST,
+	/* Key event until last byte is written to port 0x60 */
+	KB_LAT_TOTAL,
+	KB_LAT_STAGES,
+};
+
+/* Histogram buckets, bucket n holds samples in [2^(n-1), 2^n) us */
+#define KB_LAT_BUCKETS		16u
+
+/* Latency trace queued along with a scancode sequence */
+struct kb_lat_trace {
+	/* Key event timestamp, 0 if the sequence is not traced */
+	uint32_t event;
+	/* Time waited for the host so far when the sequence was queued */
+	uint32_t host_mark;
+};
+
+#ifdef CONFIG_KBCHOST_KB_LATENCY
+/**
+ * @brief Timestamp a key event from the keyboard driver.
+ *
+ * Called from kscan, PS/2 and typematic callbacks, the timestamp is passed
+ * along with the scancode sequence sent to kbchost.
+ *
+ * @retval key event timestamp in cycles, never 0.
+ */
+uint32_t kb_lat_key_event(void);
+
+/**
+ * @brief Account the enqueue stage of a key event.
+ *
+ * @param trace trace queued along with the sequence.
+ * @param event key event timestamp, 0 if the sequence doesn't come from
+ *        a key event.
+ */
+void kb_lat_enqueue(struct kb_lat_trace *trace, uint32_t event);
+
+/**
+ * @brief Account time spent waiting for the host to read port 0x60.
+ *
+ * The wait is charged to every sequence queued at that time.
+ *
+ * @param cycles time waited.
+ */
+void kb_lat_host_wait(uint32_t cycles);
+
+/**
+ * @brief Account a sequence completely written to the host.
+ *
+ * @param trace trace queued along with the sequence.
+ */
+void kb_lat_sequence(const struct kb_lat_trace *trace);
+
+static inline uint32_t kb_lat_now(void)
+{
+	return k_cycle_get_32();
+}
+#else
+static inline uint32_t kb_lat_key_event(void) { return 0; }
+static inline void kb_lat_enqueue(struct kb_lat_trace *trace,
+				  uint32_t event) {}
+static inline void kb_lat_host_wait(uint32_t cycles) {}
+static inline void kb_lat_sequence(const struct kb_lat_trace *trace) {}
+static inline uint32_t kb_lat_now(void) { return 0; }
+#endif
+
+#endif /* __KBCHOST_LATENCY_H__ */
@@ -9,9 +9,8 @@
 
 #define START_BREAK_CODE		0xf0U
 
-static bool found_break_code;
-
-int translate_key(enum scan_code_set scan_code, uint8_t *data)
+int translate_key(enum scan_code_set scan_code, bool *break_code,
+		  uint8_t *data)
 {
 	switch (scan_code) {
 	case SCAN_CODE_SET1:
@@ -20,13 +19,13 @@ int translate_key(enum scan_code_set scan_code, uint8_t *data)
 	case SCAN_CODE_SET2:
 		/* If scan code set 2, then translate to set 1 */
 		if (*data == START_BREAK_CODE) {
-			found_break_code = true;
+			*break_code = true;
 			return -EINVAL;
 		}
 		*data = kb_translation_table[*data];
-		if (found_break_code) {
+		if (*break_code) {
 			*data |= 0x80;
-			found_break_code = false;
+			*break_code = false;
 		}
 		break;
 	default:
@@ -60,14 +60,19 @@ enum scan_code_set {
  * @brief Translate scan code 2 or 1 to scan code set 1.
  * The function does nothing when set 1 is passed as input.
  *
+ * Set 2 break codes span two bytes, the caller keeps the break state of
+ * each byte stream since PS/2 devices deliver one byte at a time.
+ *
  * @param scan_code Input scan code set.
+ * @param break_code break prefix state of the byte stream being translated.
  * @param *data out parameter containing set 1
  *
  * @retval 0 If successful.
  * @retval -ENOTSUP returned when input scancode set is not supported.
  * @retval -EINVAL is returned when start of break code for set 2 is detected.
  */
-int translate_key(enum scan_code_set scan_code, uint8_t *data);
+int translate_key(enum scan_code_set scan_code, bool *break_code,
+		  uint8_t *data);
 
 #endif /* __KEYBOARD_UTILITY_H__ */
 
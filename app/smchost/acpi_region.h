@@ -75,6 +75,18 @@ struct acpi_hid_btn_sci {
 	uint8_t rsvd0:3;
 };
 
+/* ACPI 2.0 SMBus host controller interface */
+struct acpi_smb_hc {
+	uint8_t prtcl;
+	uint8_t sts;
+	uint8_t addr;
+	uint8_t cmd;
+	uint8_t data[32];
+	uint8_t bcnt;
+	uint8_t alrm_addr;
+	uint8_t alrm_data[2];
+} __attribute__((__packed__));
+
 struct acpi_tbl {
 	/* Start of ACPI space. */
 	uint8_t acpi_space;
@@ -84,8 +96,8 @@ struct acpi_tbl {
 	uint8_t acpi_gpu_temp;
 	/* [3] ACPI status flags */
 	struct acpi_status_flags acpi_flags;
-	/* [04] ACPI SMBus buffer storage */
-	uint8_t acpi_smb_buffer[40];
+	/* [04] ACPI SMBus host controller */
+	struct acpi_smb_hc acpi_smb;
 	/* [44/2C] ACPI thermal policy setting */
 	uint8_t acpi_thermal_policy;
 	/* [45/2D] ACPI passive thermal temperature */
@@ -9,17 +9,292 @@
 #include <zephyr/device.h>
 #include <soc.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
 #include "sci.h"
 #include "smc.h"
 #include "smchost.h"
+#include "smchost_latency.h"
 #include "pwrplane.h"
 #include "espi_hub.h"
 #include "acpi.h"
+#include "scicodes.h"
 LOG_MODULE_REGISTER(sci, CONFIG_SMCHOST_LOG_LEVEL);
 
 struct acpi_state_flags g_acpi_state_flags;
 
-K_MSGQ_DEFINE(sci_msgq, sizeof(uint8_t), SCIQ_SIZE, sizeof(uint8_t));
+enum sci_priority {
+	SCI_PRIO_CRITICAL,
+	SCI_PRIO_NORMAL,
+
+	SCI_PRIO_TOTAL,
+};
+
+struct sci_queue {
+	uint8_t codes[SCIQ_SIZE];
+	uint8_t count;
+};
+
+/* Noisy SCI source, notifications are held until holdoff expires */
+struct sci_rate_limit {
+	uint8_t code;
+	int64_t last_sent;
+};
+
+/* SCI codes delivered ahead of any other pending notification */
+static const uint8_t sci_critical_codes[] = {
+	SCI_THERMAL,
+	SCI_THERMTRIP,
+	SCI_PWRBTN,
+	SCI_PWRBTN_DOWN,
+	SCI_PWRBTN_UP,
+	SCI_LID,
+};
+
+/* Button press/release notifications, repeated presses within the debounce
+ * time are chatter and are discarded along with their release.
+ */
+struct sci_button {
+	uint8_t press;
+	uint8_t release;
+	bool chatter;
+	int64_t last_press;
+};
+
+/* SCI codes that only tell OS to re-evaluate a status, a pending instance
+ * covers any identical notification queued after it.
+ */
+static const uint8_t sci_status_codes[] = {
+	SCI_THERMAL,
+	SCI_THERMTRIP,
+	SCI_RPMTRIP,
+	SCI_BATTERY,
+	SCI_BATTERY_PRSNT,
+	SCI_PSRC_CHANGE,
+	SCI_ALS,
+	SCI_LID,
+	SCI_VB,
+	SCI_VIRTDOCK,
+	SCI_EVNT_USBC,
+};
+
+static struct sci_button sci_buttons[] = {
+	{ .press = SCI_PWRBTN_DOWN, .release = SCI_PWRBTN_UP },
+	{ .press = SCI_VU_PRES, .release = SCI_VU_REL },
+	{ .press = SCI_VD_PRES, .release = SCI_VD_REL },
+	{ .press = SCI_HB_PRES, .release = SCI_HB_REL },
+	{ .press = SCI_ROT_PRES, .release = SCI_ROT_REL },
+	{ .press = SCI_SLATEMODE_PRESS, .release = SCI_SLATEMODE_RELEASE },
+};
+
+static struct sci_rate_limit sci_rate_limits[] = {
+	{ .code = SCI_RPMTRIP },
+	{ .code = SCI_ALS },
+	{ .code = SCI_BATTERY },
+	{ .code = SCI_PSRC_CHANGE },
+};
+
+static struct sci_queue sci_queues[SCI_PRIO_TOTAL];
+/* Status SCI codes currently in any queue, used to merge duplicates */
+static ATOMIC_DEFINE(sci_queued, UINT8_MAX + 1);
+static struct sci_stats stats;
+static struct k_spinlock sci_lock;
+
+#ifdef CONFIG_SMCHOST_SCI_OVER_ESPI
+/* SCI virtual wire pulse width, k_timer rounds it up to the next system tick
+ * so the actual width is between this value and one tick longer.
+ */
+#define SCI_PULSE_WIDTH_US	100
+
+static void sci_pulse_end(struct k_timer *timer);
+K_TIMER_DEFINE(sci_pulse_timer, sci_pulse_end, NULL);
+static atomic_t sci_pulse_active;
+/* SCI requested while a pulse is ongoing, another pulse follows it */
+static bool sci_pulse_rearm;
+static bool sci_pulse_low;
+#endif
+
+/* Used to measure the time OS takes to query after an SCI pulse */
+static uint32_t sci_pulse_start;
+static bool sci_query_expected;
+
+static void sci_update_query_latency(void)
+{
+	uint32_t latency_us;
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	if (!sci_query_expected) {
+		k_spin_unlock(&sci_lock, key);
+		return;
+	}
+
+	latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - sci_pulse_start);
+	sci_query_expected = false;
+	stats.query_latency_us = latency_us;
+	stats.query_latency_max_us = MAX(stats.query_latency_max_us,
+					 latency_us);
+	k_spin_unlock(&sci_lock, key);
+
+	LOG_DBG("SCI to query %d us", latency_us);
+}
+
+/* Only the first pulse signaling SCIEVENT is timed, later pulses until the
+ * OS queries, re-armed and handshake pulses do not restart the measurement.
+ */
+static void sci_query_expect(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	if (!sci_query_expected) {
+		sci_pulse_start = k_cycle_get_32();
+		sci_query_expected = true;
+	}
+	k_spin_unlock(&sci_lock, key);
+}
+
+static enum sci_priority sci_code_priority(uint8_t code)
+{
+	for (int i = 0; i < ARRAY_SIZE(sci_critical_codes); i++) {
+		if (sci_critical_codes[i] == code) {
+			return SCI_PRIO_CRITICAL;
+		}
+	}
+
+	return SCI_PRIO_NORMAL;
+}
+
+static bool sci_code_mergeable(uint8_t code)
+{
+	for (int i = 0; i < ARRAY_SIZE(sci_status_codes); i++) {
+		if (sci_status_codes[i] == code) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Returns true if the notification is part of button chatter */
+static bool sci_button_chatter(uint8_t code, int64_t now)
+{
+	struct sci_button *btn;
+
+	for (int i = 0; i < ARRAY_SIZE(sci_buttons); i++) {
+		btn = &sci_buttons[i];
+		if (btn->press == code) {
+			btn->chatter = btn->last_press &&
+				       (now - btn->last_press) <
+				       CONFIG_SMCHOST_SCI_BTN_DEBOUNCE_MS;
+			if (!btn->chatter) {
+				btn->last_press = now;
+			}
+
+			return btn->chatter;
+		}
+
+		if (btn->release == code) {
+			/* Keep press/release pairs balanced for OS */
+			if (btn->chatter) {
+				btn->chatter = false;
+				return true;
+			}
+
+			return false;
+		}
+	}
+
+	return false;
+}
+
+static struct sci_rate_limit *sci_code_rate_limit(uint8_t code)
+{
+	for (int i = 0; i < ARRAY_SIZE(sci_rate_limits); i++) {
+		if (sci_rate_limits[i].code == code) {
+			return &sci_rate_limits[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool sci_code_ready(uint8_t code, int64_t now)
+{
+	struct sci_rate_limit *limit = sci_code_rate_limit(code);
+
+	if (!limit || !limit->last_sent) {
+		return true;
+	}
+
+	return (now - limit->last_sent) >= CONFIG_SMCHOST_SCI_HOLDOFF_MS;
+}
+
+/* Find next SCI that can be sent, critical notifications go first */
+static bool sci_queue_next(enum sci_priority *prio, uint8_t *idx)
+{
+	int64_t now = k_uptime_get();
+
+	for (int p = 0; p < SCI_PRIO_TOTAL; p++) {
+		struct sci_queue *q = &sci_queues[p];
+
+		for (int i = 0; i < q->count; i++) {
+			if (sci_code_ready(q->codes[i], now)) {
+				*prio = p;
+				*idx = i;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+static uint8_t sci_queue_used(void)
+{
+	return sci_queues[SCI_PRIO_CRITICAL].count +
+	       sci_queues[SCI_PRIO_NORMAL].count;
+}
+
+static bool sci_ready(void)
+{
+	enum sci_priority prio;
+	uint8_t idx;
+	bool ready;
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	ready = sci_queue_next(&prio, &idx);
+	k_spin_unlock(&sci_lock, key);
+
+	return ready;
+}
+
+static int sci_dequeue(uint8_t *code)
+{
+	enum sci_priority prio;
+	uint8_t idx;
+	struct sci_queue *q;
+	struct sci_rate_limit *limit;
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	if (!sci_queue_next(&prio, &idx)) {
+		k_spin_unlock(&sci_lock, key);
+		return -ENOMSG;
+	}
+
+	q = &sci_queues[prio];
+	*code = q->codes[idx];
+	q->count--;
+	memmove(&q->codes[idx], &q->codes[idx + 1], q->count - idx);
+	atomic_clear_bit(sci_queued, *code);
+
+	limit = sci_code_rate_limit(*code);
+	if (limit) {
+		limit->last_sent = k_uptime_get();
+	}
+
+	stats.sent++;
+	k_spin_unlock(&sci_lock, key);
+
+	return 0;
+}
 
 void sci_queue_init(void)
 {
@@ -28,21 +303,91 @@ void sci_queue_init(void)
 
 void sci_queue_flush(void)
 {
-	LOG_DBG("%s %d SCI flushed", __func__, k_msgq_num_used_get(&sci_msgq));
-	k_msgq_purge(&sci_msgq);
+	uint8_t flushed;
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	flushed = sci_queue_used();
+	stats.flushed += flushed;
+	for (int p = 0; p < SCI_PRIO_TOTAL; p++) {
+		sci_queues[p].count = 0;
+	}
+
+	atomic_clear(sci_queued);
+	k_spin_unlock(&sci_lock, key);
+	LOG_DBG("%s %d SCI flushed", __func__, flushed);
+}
+
+void sci_get_stats(struct sci_stats *sci_stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	*sci_stats = stats;
+	k_spin_unlock(&sci_lock, key);
+}
+
+#ifdef CONFIG_SMCHOST_SCI_OVER_ESPI
+static void sci_pulse_start_low(void)
+{
+	int ret;
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
+
+	stats.pulses++;
+	sci_pulse_low = true;
+	k_spin_unlock(&sci_lock, key);
+
+	ret = espihub_send_vw(ESPI_VWIRE_SIGNAL_SCI, ESPIHUB_VW_LOW);
+	if (ret) {
+		LOG_WRN("SCI failed");
+	}
+
+	k_timer_start(&sci_pulse_timer, K_USEC(SCI_PULSE_WIDTH_US), K_NO_WAIT);
+}
+
+static void sci_pulse_end(struct k_timer *timer)
+{
+	int ret;
+	bool rearm;
+	k_spinlock_key_t key;
+
+	/* Idle time before re-armed pulse elapsed */
+	if (!sci_pulse_low) {
+		sci_pulse_start_low();
+		return;
+	}
+
+	ret = espihub_send_vw(ESPI_VWIRE_SIGNAL_SCI, ESPIHUB_VW_HIGH);
+	if (ret) {
+		LOG_WRN("SCI failed");
+	}
+
+	key = k_spin_lock(&sci_lock);
+	sci_pulse_low = false;
+	rearm = sci_pulse_rearm;
+	sci_pulse_rearm = false;
+	if (!rearm) {
+		atomic_clear(&sci_pulse_active);
+	}
+	k_spin_unlock(&sci_lock, key);
+
+	/* Host may have sampled SCI status before the request, so it needs
+	 * a new falling edge once the line has been released.
+	 */
+	if (rearm) {
+		k_timer_start(timer, K_USEC(SCI_PULSE_WIDTH_US), K_NO_WAIT);
+	}
 }
+#endif
 
 /* System control interrupt are used to notify OS of ACPI events,
  * Do not send SCI when not in acpi mode or system is in Sx.
  * SCI is a pulse so need to send a eSPI virtual wire packet with zero then
  * then another eSPI VW packet with one.
- * eSPI driver should guarantee both virtual are transmitted, a delay between
- * packets should never be added here.
+ * eSPI driver should guarantee both virtual are transmitted, the pulse is
+ * completed by a one-shot timer so callers never wait for it. SCI requests
+ * while a pulse is ongoing re-arm it, so a new pulse follows the current one.
  */
 void generate_sci(void)
 {
-	int ret;
-
 	if ((!g_acpi_state_flags.sci_enabled) ||
 	    (!g_acpi_state_flags.acpi_mode)) {
 		LOG_DBG("SCI is disabled");
@@ -51,16 +396,21 @@ void generate_sci(void)
 
 	if (pwrseq_system_state() == SYSTEM_S0_STATE) {
 #ifdef CONFIG_SMCHOST_SCI_OVER_ESPI
-		ret = espihub_send_vw(ESPI_VWIRE_SIGNAL_SCI, ESPIHUB_VW_LOW);
-		if (ret) {
-			LOG_WRN("SCI failed");
-		}
-		k_busy_wait(100);
+		k_spinlock_key_t key;
 
-		ret = espihub_send_vw(ESPI_VWIRE_SIGNAL_SCI, ESPIHUB_VW_HIGH);
-		if (ret) {
-			LOG_WRN("SCI failed");
+		acpi_lat_mark(ACPI_LAT_SCI);
+		key = k_spin_lock(&sci_lock);
+		if (!atomic_cas(&sci_pulse_active, 0, 1)) {
+			if (!sci_pulse_rearm) {
+				stats.pulses_rearmed++;
+			}
+			sci_pulse_rearm = true;
+			k_spin_unlock(&sci_lock, key);
+			return;
 		}
+		k_spin_unlock(&sci_lock, key);
+
+		sci_pulse_start_low();
 #else
 #warning "SCI using physical pin not supported"
 #endif
@@ -76,10 +426,12 @@ void check_sci_queue(void)
 		return;
 	}
 
-	if (k_msgq_num_used_get(&sci_msgq) == 0) {
+	/* Notifications held by rate limit are signaled once ready */
+	if (!sci_ready()) {
 		acpi_set_flag(ACPI_EC_0, ACPI_FLAG_SCIEVENT, 0);
 	} else {
 		LOG_DBG("SCI pending");
+		sci_query_expect();
 		acpi_set_flag(ACPI_EC_0, ACPI_FLAG_SCIEVENT, 1);
 		generate_sci();
 	}
@@ -89,7 +441,7 @@ bool sci_pending(void)
 {
 	return (g_acpi_state_flags.sci_enabled &&
 		g_acpi_state_flags.acpi_mode &&
-		k_msgq_num_used_get(&sci_msgq) > 0);
+		sci_queue_used() > 0);
 }
 
 void send_sci_events(void)
@@ -101,24 +453,20 @@ void send_sci_events(void)
 		return;
 	}
 
+	sci_update_query_latency();
+
 	if (acpi_get_flag(ACPI_EC_0, ACPI_FLAG_OBF)) {
 		LOG_WRN("No SCI sent. Some other transaction in progress");
 		return;
 	}
 
-	ret = k_msgq_get(&sci_msgq, &evt_byte, K_NO_WAIT);
-	if (ret < 0) {
-		switch (ret) {
-		case -ENOMSG:
-			LOG_DBG("SCI msgq Empty!");
-			break;
-		default:
-			LOG_ERR("SCI Queue Fetch failure %02x", ret);
-			return;
-		}
+	ret = sci_dequeue(&evt_byte);
+	if (ret == -ENOMSG) {
+		LOG_DBG("SCI queue Empty!");
 	}
 
 	acpi_write_odr(ACPI_EC_0, evt_byte);
+	acpi_lat_mark(ACPI_LAT_OBF);
 	if (ret == -ENOMSG) {
 		acpi_set_flag(ACPI_EC_0, ACPI_FLAG_SCIEVENT, 0);
 	}
@@ -126,10 +474,43 @@ void send_sci_events(void)
 	generate_sci();
 }
 
-void enqueue_sci(uint8_t code)
+static void sci_enqueue(uint8_t code)
 {
-	int ret;
+	struct sci_queue *q = &sci_queues[sci_code_priority(code)];
+	k_spinlock_key_t key = k_spin_lock(&sci_lock);
 
+	if (sci_button_chatter(code, k_uptime_get())) {
+		stats.debounced++;
+		k_spin_unlock(&sci_lock, key);
+		LOG_DBG("SCI %02x debounced", code);
+		return;
+	}
+
+	/* Same status already pending, OS will evaluate it only once */
+	if (sci_code_mergeable(code) &&
+	    atomic_test_and_set_bit(sci_queued, code)) {
+		stats.merged++;
+		k_spin_unlock(&sci_lock, key);
+		LOG_DBG("SCI %02x merged", code);
+		return;
+	}
+
+	if (q->count >= SCIQ_SIZE) {
+		atomic_clear_bit(sci_queued, code);
+		stats.dropped++;
+		k_spin_unlock(&sci_lock, key);
+		LOG_ERR("SCI queue full, %02x dropped", code);
+		return;
+	}
+
+	q->codes[q->count++] = code;
+	stats.queued++;
+	k_spin_unlock(&sci_lock, key);
+	LOG_INF("enqueued SCI %02x", code);
+}
+
+void enqueue_sci(uint8_t code)
+{
 	if ((!g_acpi_state_flags.sci_enabled) ||
 	    (!g_acpi_state_flags.acpi_mode)) {
 		LOG_DBG("SCI not queued not in ACPI mode %02x", code);
@@ -137,11 +518,7 @@ void enqueue_sci(uint8_t code)
 	}
 
 	if (pwrseq_system_state() == SYSTEM_S0_STATE) {
-		LOG_INF("enqueued SCI %02x", code);
-		ret = k_msgq_put(&sci_msgq, (void *)&code, K_NO_WAIT);
-		if (ret < 0) {
-			LOG_ERR("SCI msgq Put failure %02x", ret);
-		}
+		sci_enqueue(code);
 	} else {
 		LOG_WRN("SCI not queued, power check failed %02x", code);
 	}
@@ -155,3 +532,33 @@ inline bool is_system_in_acpi_mode(void)
 {
 	return g_acpi_state_flags.acpi_mode;
 }
+
+#ifdef CONFIG_SHELL
+static int cmd_sci_stats(const struct shell *sh, size_t argc, char **argv)
+{
+	struct sci_stats sci_stats;
+
+	sci_get_stats(&sci_stats);
+
+	shell_print(sh, "queued %u merged %u debounced %u dropped %u",
+		    sci_stats.queued, sci_stats.merged, sci_stats.debounced,
+		    sci_stats.dropped);
+	shell_print(sh, "flushed %u sent %u pending %u", sci_stats.flushed,
+		    sci_stats.sent, sci_queue_used());
+	shell_print(sh, "pulses %u rearmed %u", sci_stats.pulses,
+		    sci_stats.pulses_rearmed);
+	shell_print(sh, "query latency %u us max %u us",
+		    sci_stats.query_latency_us,
+		    sci_stats.query_latency_max_us);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_sci,
+	SHELL_CMD(stats, NULL, "Show SCI notification statistics",
+		  cmd_sci_stats),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(sci, &sub_sci, "SCI notifications", NULL);
+#endif
@@ -10,6 +10,32 @@
 /* Size of SMC to SCI host buffer */
 #define SCIQ_SIZE               32
 
+/**
+ * @brief SCI notifications statistics.
+ */
+struct sci_stats {
+	/* Notifications added to queue */
+	uint32_t queued;
+	/* Notifications merged with an identical pending notification */
+	uint32_t merged;
+	/* Button notifications discarded as chatter */
+	uint32_t debounced;
+	/* Notifications lost due to queue full */
+	uint32_t dropped;
+	/* Notifications discarded due to host reset */
+	uint32_t flushed;
+	/* Notifications sent to OS */
+	uint32_t sent;
+	/* SCI pulses generated */
+	uint32_t pulses;
+	/* SCI pulses re-armed by requests during an ongoing pulse */
+	uint32_t pulses_rearmed;
+	/* Time between last SCI pulse and OS query command */
+	uint32_t query_latency_us;
+	/* Maximum time between SCI pulse and OS query command */
+	uint32_t query_latency_max_us;
+};
+
 /**
  * @brief  Initialize the SCI Queue.
  */
@@ -28,6 +54,8 @@ void sci_queue_flush(void);
  * @brief Generates an SCI.
  *
  * The SCI signal can implemented using an output pin or a eSPI virtual wire.
+ * The pulse completes asynchronously, requests while a pulse is ongoing
+ * re-arm it so another pulse follows.
  */
 void generate_sci(void);
 
@@ -54,10 +82,21 @@ void send_sci_events(void);
 /**
  * @brief Stores data to send to the operating system in the SCI queue.
  *
+ * Duplicated status notifications already pending are merged, button
+ * chatter is discarded, critical notifications are sent ahead of others
+ * and noisy sources are held to avoid flooding OS.
+ *
  * @param code the byte to push onto queue.
  */
 void enqueue_sci(uint8_t Code);
 
+/**
+ * @brief Retrieve SCI notifications statistics.
+ *
+ * @param sci_stats buffer to hold the statistics.
+ */
+void sci_get_stats(struct sci_stats *sci_stats);
+
 /**
  * @brief Check if system is in ACPI mode or not.
  *
@@ -37,7 +37,7 @@ static const bool acpi_tbl_attr[256] = {
 	/* [3 / 3] struct acpi_status_flags acpi_flags; */
 	ACPI_ATTR_READ_ONLY,
 
-	/* [4 / 4] uint8_t acpi_smb_buffer[40]; */
+	/* [4 / 4] struct acpi_smb_hc acpi_smb; */
 	ACPI_ATTR_READ_WRITE,
 
 	/* [5 / 5]  */
@@ -794,6 +794,10 @@ static const bool acpi_tbl_attr[256] = {
 	ACPI_ATTR_READ_ONLY,
 };
 
+/* ACPI offsets with subscribers and offsets written by the host */
+static ATOMIC_DEFINE(acpi_notify, ACPI_MAX_DATA + 1);
+static ATOMIC_DEFINE(acpi_dirty, ACPI_MAX_DATA + 1);
+
 static uint8_t g_wake_status;
 
 uint8_t smc_get_wake_sts(void)
@@ -910,3 +914,49 @@ bool smc_is_acpi_offset_write_permitted(uint8_t offset)
 {
 	return acpi_tbl_attr[offset];
 }
+
+void smc_init(void)
+{
+	STRUCT_SECTION_FOREACH(acpi_subscriber, sub) {
+		for (int i = 0; i < sub->len; i++) {
+			atomic_set_bit(acpi_notify, sub->offset + i);
+		}
+	}
+}
+
+void smc_acpi_write(uint8_t offset, uint8_t data)
+{
+	*((uint8_t *)&g_acpi_tbl + offset) = data;
+
+	if (atomic_test_bit(acpi_notify, offset)) {
+		atomic_set_bit(acpi_dirty, offset);
+#ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
+		smchost_signal_request();
+#endif
+	}
+}
+
+void smc_acpi_notify_changes(void)
+{
+	ATOMIC_DEFINE(changed, ACPI_MAX_DATA + 1);
+	bool pending = false;
+
+	for (int i = 0; i < ARRAY_SIZE(acpi_dirty); i++) {
+		changed[i] = atomic_clear(&acpi_dirty[i]);
+		pending |= (changed[i] != 0);
+	}
+
+	if (!pending) {
+		return;
+	}
+
+	/* Notify each subscriber once even if several offsets changed */
+	STRUCT_SECTION_FOREACH(acpi_subscriber, sub) {
+		for (int i = 0; i < sub->len; i++) {
+			if (atomic_test_bit(changed, sub->offset + i)) {
+				sub->handler(sub->offset);
+				break;
+			}
+		}
+	}
+}
@@ -8,6 +8,7 @@
 #define __SMC_H__
 
 #include <soc.h>
+#include <zephyr/sys/iterable_sections.h>
 #include "acpi_region.h"
 
 /** Number of loops to wait for host in burst */
@@ -56,7 +57,42 @@ enum wake_reason {
 	WAKE_HOME_BUTTON_EVENT = BIT(7),
 };
 
+/**
+ * @brief Handler called when host writes a subscribed ACPI offset.
+ *
+ * @param offset ACPI table offset written by the host.
+ */
+typedef void (*acpi_change_handler_t)(uint8_t offset);
+
+/**
+ * @brief Subscription to host writes over a range of ACPI offsets.
+ */
+struct acpi_subscriber {
+	/* First ACPI table offset monitored */
+	uint8_t offset;
+	/* Number of consecutive offsets monitored */
+	uint8_t len;
+	/* Called from SMC host task after host writes any of the offsets */
+	acpi_change_handler_t handler;
+};
+
+/**
+ * @brief Subscribe to host writes of an ACPI table field.
+ *
+ * @param _name subscription identifier.
+ * @param _field field name in struct acpi_tbl.
+ * @param _handler function called after host writes the field.
+ */
+#define SMC_ACPI_SUBSCRIBE(_name, _field, _handler)			\
+	static const STRUCT_SECTION_ITERABLE(acpi_subscriber, _name) = {\
+		.offset = offsetof(struct acpi_tbl, _field),		\
+		.len = sizeof(((struct acpi_tbl *)0)->_field),		\
+		.handler = _handler,					\
+	}
 
+/**
+ * @brief Initialize ACPI table change notifications.
+ */
 void smc_init(void);
 
 /**
@@ -132,4 +168,21 @@ void smc_update_pch_dts_temperature(int temp);
  */
 bool smc_is_acpi_offset_write_permitted(uint8_t offset);
 
+/**
+ * @brief Update ACPI offset on behalf of the host.
+ *
+ * Marks the offset as changed if any module subscribed to it.
+ *
+ * @param offset acpi table offset.
+ * @param data value written by the host.
+ */
+void smc_acpi_write(uint8_t offset, uint8_t data);
+
+/**
+ * @brief Notify subscribers about ACPI offsets changed by the host.
+ *
+ * Note: Subscribers are notified in caller context.
+ */
+void smc_acpi_notify_changes(void);
+
 #endif /* __SMC_H__ */
@@ -12,6 +12,7 @@
 #include "smc.h"
 #include "smchost.h"
 #include "smchost_commands.h"
+#include "smchost_latency.h"
 #include "scicodes.h"
 #include "sci.h"
 #include "acpi.h"
@@ -21,6 +22,7 @@
 #include "espi_hub.h"
 #include "peci_hub.h"
 #include "led.h"
+#include "memops.h"
 #ifdef CONFIG_DNX_SUPPORT
 #include "dnx.h"
 #endif
@@ -33,24 +35,38 @@ uint8_t host_res[SMCHOST_MAX_BUF_SIZE];
 uint8_t host_req_len;
 uint8_t host_res_len;
 uint8_t host_res_idx;
-uint8_t prev_kb_bklt_pwm_duty;
 
 struct acpi_tbl g_acpi_tbl;
 
 static bool proc_host_send(void);
-static void proc_acpi_burst(void);
-static void service_system_acpi_cmds(void);
-static uint8_t smchost_req_length(uint8_t command);
-static void smchost_cmd_handler(uint8_t command);
-static void handle_kb_backlight_pwm(void);
+static bool acpi_burst_wait_ibf(void);
+static void acpi_burst_exit(void);
+static const struct smchost_cmd *smchost_cmd_lookup(uint8_t command);
 
-/* Track OS requests for different ACPI modes */
-static uint8_t acpi_burst_flag;
-static uint8_t acpi_normal_flag;
+/* Host commands registered by all modules indexed by command code */
+static const struct smchost_cmd *cmd_tbl[UINT8_MAX + 1];
+
+/* Host command currently receiving data bytes */
+static const struct smchost_cmd *host_cmd;
+
+/* Data bytes expected for the host command in progress */
+static uint8_t host_cmd_len;
+
+/* Delay between IBF polls while OS keeps the EC in burst mode */
+#define BURST_POLL_DELAY_US	5u
+
+/* Indicates OS has placed the EC in ACPI burst mode */
+static bool acpi_burst_active;
 
 /* PLT_RST# status */
 static uint8_t pltrst_signal_sts;
 
+/* Serializes response bytes pushed from ACPI events and smchost task */
+static struct k_spinlock host_res_lock;
+
+/* Serializes host bytes serviced from ACPI events and smchost task */
+static struct k_spinlock acpi_service_lock;
+
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 /* Trigger from asynchronous events generated by other EC FW modules
  * of request from host.
@@ -83,7 +99,7 @@ void smchost_err_handler(void)
 #endif
 }
 
-static void smchost_acpi_handler(void)
+static void smchost_acpi_service(void)
 {
 	while (acpi_get_flag(ACPI_EC_0, ACPI_FLAG_IBF)) {
 		if (acpi_get_flag(ACPI_EC_0, ACPI_FLAG_CD)) {
@@ -94,10 +110,26 @@ static void smchost_acpi_handler(void)
 			host_req[host_req_len] = acpi_read_idr(ACPI_EC_0);
 			LOG_DBG("Rcv EC cmd: %02X",
 				host_req[host_req_len]);
+			acpi_lat_start(host_req[0]);
 
+			/* Reject unknown commands before buffering data */
+			host_cmd = smchost_cmd_lookup(host_req[0]);
+			if (!host_cmd) {
+				acpi_lat_end();
+				host_req[0] = 0;
+				continue;
+			}
+
+			host_cmd_len = host_cmd->req_len;
+		} else if (!host_cmd) {
+			/* Discard data not associated to a valid command */
+			uint8_t data = acpi_read_idr(ACPI_EC_0);
+
+			LOG_DBG("Drop data %02X", data);
+			continue;
 		} else {
 			/* It is data */
-			if (host_req[0] == EC_WRITE) {
+			if (host_req[0] == EC_WRITE && !acpi_burst_active) {
 				generate_sci();
 			}
 
@@ -116,22 +148,56 @@ static void smchost_acpi_handler(void)
 		/* When a command is received check if the command corresponds
 		 * to a ACPI read/write operation then ackwnowledge the OS
 		 * before performing the operation.
+		 * In burst mode the OS polls the status register instead.
 		 */
-		if (host_req[0]) {
-			if ((host_req[0] == EC_READ) ||
-			    (host_req[0] == EC_WRITE)) {
-				generate_sci();
+		if (((host_req[0] == EC_READ) ||
+		     (host_req[0] == EC_WRITE)) && !acpi_burst_active) {
+			generate_sci();
+		}
+
+		/* Variable length commands provide the data byte count. A
+		 * count exceeding the buffer dispatches the command right
+		 * away, so its handler answers with an error status, and the
+		 * data that follows is discarded.
+		 */
+		if ((host_cmd->flags & SMCHOST_CMD_FLAG_VAR_LEN) &&
+		    host_req_len && host_req_len == host_cmd->req_len) {
+			if (host_req[host_req_len] >=
+			    SMCHOST_MAX_BUF_SIZE - host_cmd_len) {
+				LOG_WRN("Cmd %02X too long", host_req[0]);
+			} else {
+				host_cmd_len += host_req[host_req_len];
 			}
+		}
 
-			if (smchost_req_length(host_req[0]) == host_req_len) {
-				LOG_INF("EC Command: %02X", host_req[0]);
-				smchost_cmd_handler(host_req[0]);
-				host_req[0] = 0;
+		if (host_cmd_len == host_req_len) {
+			LOG_INF("EC Command: %02X", host_req[0]);
+			acpi_lat_mark(ACPI_LAT_DISPATCH);
+			host_cmd->handler();
+			/* Direct responses, i.e. EC_READ or query, are already
+			 * in the output buffer, queued ones complete once their
+			 * last byte is written.
+			 */
+			if (!host_res_len) {
+				acpi_lat_end();
 			}
+			host_cmd = NULL;
+			host_req[0] = 0;
 		}
 
 		host_req_len++;
 	}
+}
+
+static void smchost_acpi_handler(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&acpi_service_lock);
+
+	smchost_acpi_service();
+	k_spin_unlock(&acpi_service_lock, key);
+
+	/* Host reading the output buffer allows next response byte */
+	proc_host_send();
 
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 	smchost_signal_request();
@@ -283,6 +349,7 @@ static void smchost_host_rst_warn_handler(uint8_t host_rst_wrn_sts)
 	if (host_rst_wrn_sts) {
 		g_acpi_state_flags.sci_enabled = 0;
 		sci_queue_flush();
+		acpi_burst_exit();
 	}
 }
 
@@ -295,6 +362,19 @@ static inline int smchost_task_init(void)
 	k_sem_init(&acpi_lock, 0, 1);
 #endif
 
+	/* Build command lookup before any host request can be received */
+	STRUCT_SECTION_FOREACH(smchost_cmd, cmd) {
+		if (cmd_tbl[cmd->command]) {
+			LOG_ERR("Host command %02X already registered",
+				cmd->command);
+			continue;
+		}
+
+		cmd_tbl[cmd->command] = cmd;
+	}
+
+	smc_init();
+
 	/* Initialize flags */
 	sci_queue_init();
 
@@ -325,7 +405,6 @@ static inline int smchost_task_init(void)
 	g_acpi_tbl.acpi_flags2.pwr_btn = 1;
 	g_acpi_tbl.acpi_flags.lid_open = 1;
 	g_acpi_tbl.kb_bklt_pwm_duty = 0;
-	prev_kb_bklt_pwm_duty = 0;
 	led_init(LED_KBD_BKLT);
 
 #ifdef EC_M_2_SSD_PLN
@@ -335,6 +414,23 @@ static inline int smchost_task_init(void)
 	return 0;
 }
 
+/* While in burst mode keep servicing back to back bytes without waiting
+ * for another interrupt. Polling is done here rather than in interrupt
+ * context, so other interrupts are not held while the OS is idle.
+ */
+static void acpi_burst_poll(void)
+{
+	k_spinlock_key_t key;
+
+	while (acpi_burst_active && acpi_burst_wait_ibf()) {
+		key = k_spin_lock(&acpi_service_lock);
+		smchost_acpi_service();
+		k_spin_unlock(&acpi_service_lock, key);
+
+		proc_host_send();
+	}
+}
+
 static bool smchost_process_tasks(void)
 {
 	bool pend_data;
@@ -342,24 +438,19 @@ static bool smchost_process_tasks(void)
 #ifdef EC_M_2_SSD_PLN
 	manage_pln_signal();
 #endif
-	if (acpi_burst_flag) {
-		proc_acpi_burst();
-	}
-
-	if (acpi_normal_flag) {
-		acpi_set_flag(ACPI_EC_0, ACPI_FLAG_ACPIBURST, 0);
-		acpi_normal_flag = 0;
-		generate_sci();
-	}
+	acpi_burst_poll();
 
 	/* Check for SMI/SCI pending and service any commands
 	 * from the host
 	 */
 	check_sci_queue();
-	service_system_acpi_cmds();
+	smc_acpi_notify_changes();
 	pend_data = proc_host_send();
 
-	handle_kb_backlight_pwm();
+#ifdef CONFIG_SMCHOST_OBE_EVENT
+	/* Remaining response bytes are pushed on output buffer empty */
+	pend_data = false;
+#endif
 
 	return (sci_pending() || pend_data);
 }
@@ -379,7 +470,13 @@ void smchost_thread(void *p1, void *p2, void *p3)
 
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 	while (true) {
+#ifdef CONFIG_SMCHOST_OBE_EVENT
+		/* Poll periodically only as fallback while response pending */
+		k_sem_take(&acpi_lock, host_res_len ? K_MSEC(period) :
+			   K_FOREVER);
+#else
 		k_sem_take(&acpi_lock, K_FOREVER);
+#endif
 		LOG_DBG("%s process\n", __func__);
 
 		/* 1) Process all smchost actions triggered by event
@@ -389,9 +486,11 @@ void smchost_thread(void *p1, void *p2, void *p3)
 		do {
 			pend_processing = smchost_process_tasks();
 
-			/* Perform delay only in SCI pending notification */
+			/* Wait while SCI notification is pending, OS query
+			 * or any other host access wakes the task earlier.
+			 */
 			if (sci_pending()) {
-				k_msleep(period);
+				k_sem_take(&acpi_lock, K_MSEC(period));
 			}
 
 		} while (pend_processing);
@@ -407,6 +506,9 @@ void smchost_thread(void *p1, void *p2, void *p3)
 
 static bool proc_host_send(void)
 {
+	k_spinlock_key_t key = k_spin_lock(&host_res_lock);
+	bool pending;
+
 	if (host_res_len > 0) {
 		uint8_t flag = acpi_get_flag(ACPI_EC_0, ACPI_FLAG_OBF);
 
@@ -414,12 +516,19 @@ static bool proc_host_send(void)
 		if (!flag) {
 			LOG_DBG("WriteODR %x",  host_res[host_res_idx]);
 			acpi_write_odr(ACPI_EC_0, host_res[host_res_idx]);
+			acpi_lat_mark(ACPI_LAT_OBF);
 			host_res_idx++;
 			host_res_len--;
+			if (!host_res_len) {
+				acpi_lat_end();
+			}
 		}
 	}
 
-	return (host_res_len > 0);
+	pending = (host_res_len > 0);
+	k_spin_unlock(&host_res_lock, key);
+
+	return pending;
 }
 
 /**
@@ -430,6 +539,7 @@ static bool proc_host_send(void)
  */
 void send_to_host(uint8_t *pdata, uint8_t Len)
 {
+	k_spinlock_key_t key = k_spin_lock(&host_res_lock);
 	int i;
 
 	for (i = 0; i < Len; i++) {
@@ -439,11 +549,23 @@ void send_to_host(uint8_t *pdata, uint8_t Len)
 
 	host_res_len = Len;
 	host_res_idx = 0;
+	k_spin_unlock(&host_res_lock, key);
+
+	/* First byte does not need to wait for smchost task */
+	if (proc_host_send()) {
+#ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
+		smchost_signal_request();
+#endif
+	}
 }
 
-static void service_system_acpi_cmds(void)
+static void service_system_acpi_cmds(uint8_t offset)
 {
+	const struct smchost_cmd *cmd;
+
+	/* Command stays latched until ACPI mode is enabled */
 	if (!g_acpi_state_flags.acpi_mode) {
+		LOG_DBG("ACPI CMD %x latched", g_acpi_tbl.acpi_host_command);
 		return;
 	}
 
@@ -453,16 +575,47 @@ static void service_system_acpi_cmds(void)
 
 	/* Call the appropriate function from the table */
 	LOG_INF("Srcv ACPI CMD %x",  g_acpi_tbl.acpi_host_command);
-	smchost_cmd_handler(g_acpi_tbl.acpi_host_command);
+	cmd = smchost_cmd_lookup(g_acpi_tbl.acpi_host_command);
+	if (cmd) {
+		cmd->handler();
+	}
 
 	/* Clear the command after execution */
 	g_acpi_tbl.acpi_host_command = 0;
 }
 
-void host_cmd_default(uint8_t command)
+/**
+ * @brief Find the handler for a host command.
+ *
+ * Commands without handler or not permitted in current system state are
+ * rejected.
+ *
+ * @param command command code sent by the host.
+ * @return the command descriptor, NULL if command has to be rejected.
+ */
+static const struct smchost_cmd *smchost_cmd_lookup(uint8_t command)
 {
-	/* Log the execution to know BIOS send an unsupported command */
-	LOG_WRN("%s: command 0x%X without handler", __func__, command);
+	const struct smchost_cmd *cmd = cmd_tbl[command];
+
+	if (!cmd) {
+		/* Log the execution to know BIOS send an unsupported command */
+		LOG_WRN("%s: command 0x%X without handler", __func__, command);
+		return NULL;
+	}
+
+	if (!(cmd->pwr_states & BIT(pwrseq_system_state()))) {
+		LOG_WRN("Command 0x%X not permitted in state %d", command,
+			pwrseq_system_state());
+		return NULL;
+	}
+
+	if ((cmd->flags & SMCHOST_CMD_FLAG_ACPI_MODE) &&
+	    !g_acpi_state_flags.acpi_mode) {
+		LOG_WRN("Command 0x%X requires ACPI mode", command);
+		return NULL;
+	}
+
+	return cmd;
 }
 
 static void acpi_read_ec(void)
@@ -477,8 +630,12 @@ static void acpi_read_ec(void)
 		data = acpi_idx;
 	}
 
+	/* In burst mode the OS polls the status register instead */
 	if (acpi_send_byte(ACPI_EC_0, data) == 0) {
-		generate_sci();
+		acpi_lat_mark(ACPI_LAT_OBF);
+		if (!acpi_burst_active) {
+			generate_sci();
+		}
 	}
 }
 
@@ -489,7 +646,7 @@ static void acpi_write_ec(void)
 
 	if (acpi_idx <= ACPI_MAX_INDEX) {
 		if (smc_is_acpi_offset_write_permitted(acpi_idx)) {
-			*((uint8_t *)&g_acpi_tbl + acpi_idx) = data;
+			smc_acpi_write(acpi_idx, data);
 			LOG_DBG("ACPI ECW Data [%02x]: %02x", acpi_idx, data);
 		} else {
 			LOG_WRN("ACPI WR not permitted at offset: %02x",
@@ -503,44 +660,56 @@ uint8_t get_pltrst_signal_sts(void)
 	return pltrst_signal_sts;
 }
 
-#ifdef CONFIG_THERMAL_MANAGEMENT
-static void change_peci_access_mode(void)
+/**
+ * @brief Wait for next byte from OS while in burst mode.
+ *
+ * ACPI burst mode requires the EC to service consecutive bytes promptly,
+ * poll the input buffer for a bounded time before going back to sleep.
+ * Only called from smchost task.
+ *
+ * @return true if input buffer got data, false if the host was idle.
+ */
+static bool acpi_burst_wait_ibf(void)
 {
-#ifndef CONFIG_DEPRECATED_HW_STRAP_BASED_PECI_MODE_SEL
-	LOG_DBG("%s:Host peci_mode : %x", __func__, host_req[1]);
-	peci_access_mode_config(host_req[1]);
-#endif /* CONFIG_DEPRECATED_HW_STRAP_BASED_PECI_MODE_SEL */
+	for (uint32_t i = 0; i < BURST_TIMEOUT; i++) {
+		if (acpi_get_flag(ACPI_EC_0, ACPI_FLAG_IBF)) {
+			return true;
+		}
+
+		k_busy_wait(BURST_POLL_DELAY_US);
+	}
+
+	return false;
 }
-#endif
 
-static void acpi_burst_ec(void)
+static void acpi_burst_exit(void)
 {
-	acpi_burst_flag = 1;
+	acpi_burst_active = false;
+	acpi_set_flag(ACPI_EC_0, ACPI_FLAG_ACPIBURST, 0);
 }
 
-static void proc_acpi_burst(void)
+static void acpi_burst_ec(void)
 {
-	acpi_burst_flag = 0;
 	/* Tell host that we're burst */
 	acpi_set_flag(ACPI_EC_0, ACPI_FLAG_ACPIBURST, 1);
 	if (!acpi_send_byte(ACPI_EC_0, SCI_BURST_ACK)) {
-		/* Do not process burst mode command to avoid EC timeout
-		 * errors in OS
-		 */
+		acpi_lat_mark(ACPI_LAT_OBF);
+		acpi_burst_active = true;
 		generate_sci();
 		return;
-	} else {
-		LOG_ERR("Burst ACK failed");
 	}
 
+	LOG_ERR("Burst ACK failed");
+
 	/* Abort burst */
-	acpi_set_flag(ACPI_EC_0, ACPI_FLAG_ACPIBURST, 0);
+	acpi_burst_exit();
 	generate_sci();
 }
 
 static void acpi_normal_ec(void)
 {
-	acpi_normal_flag = 1;
+	acpi_burst_exit();
+	generate_sci();
 }
 
 static void acpi_query_ec(void)
@@ -561,6 +730,9 @@ static void enable_acpi(void)
 
 	/* Clear the event flag in host status */
 	acpi_set_flag(ACPI_EC_0, ACPI_FLAG_SCIEVENT, 0);
+
+	/* Serve command written by BIOS before ACPI mode was enabled */
+	service_system_acpi_cmds(offsetof(struct acpi_tbl, acpi_host_command));
 }
 
 static void disable_acpi(void)
@@ -579,139 +751,112 @@ static void read_acpi_space(void)
 
 static void write_acpi_space(void)
 {
-	*((uint8_t *) &g_acpi_tbl + host_req[1]) = host_req[2];
+	smc_acpi_write(host_req[1], host_req[2]);
 }
 
-static uint8_t smchost_req_length(uint8_t command)
+static bool acpi_block_valid(uint8_t offset, uint8_t count)
 {
-	switch (command) {
-	case SMCHOST_PLN_CONFIG:
-	case SMCHOST_CS_LOW_PWR_MODE_SET:
-	case SMCHOST_SET_DSW_MODE:
-	case SMCHOST_PG3_SET_MODE:
-	case SMCHOST_ACPI_READ:
-	case SMCHOST_READ_ACPI_SPACE:
-	case SMCHOST_SET_PECI_ACCESS_MODE:
-	case SMCHOST_HID_BTN_SCI_CONTROL:
-#ifdef CONFIG_THERMAL_MANAGEMENT
-	case SMCHOST_BIOS_FAN_CONTROL:
-	case SMCHOST_SET_SHDWN_THRESHOLD:
-#endif
-		return 1;
+	if (!count || count > SMCHOST_ACPI_BLOCK_MAX ||
+	    offset + count - 1 > ACPI_MAX_INDEX) {
+		LOG_WRN("Invalid ACPI block %02x len %d", offset, count);
+		return false;
+	}
 
-	case SMCHOST_ACPI_WRITE:
-	case SMCHOST_WRITE_ACPI_SPACE:
-#ifdef CONFIG_THERMAL_MANAGEMENT
-	case SMCHOST_SET_OS_ACTIVE_TRIP:
-#endif
-		return 2;
+	return true;
+}
+
+/**
+ * @brief Read contiguous bytes from ACPI region.
+ *
+ * host_req[1] is the offset and host_req[2] the number of bytes. Response
+ * is a status byte followed by the data if the range is valid.
+ */
+static void read_acpi_block(void)
+{
+	uint8_t res[SMCHOST_ACPI_BLOCK_MAX + 1];
+	uint8_t offset = host_req[1];
+	uint8_t count = host_req[2];
 
-	default:
-		return 0;
+	if (!acpi_block_valid(offset, count)) {
+		res[0] = SMCHOST_ACPI_BLOCK_INVALID;
+		send_to_host(res, 1);
+		return;
 	}
+
+	res[0] = SMCHOST_ACPI_BLOCK_OK;
+	memcpys(&res[1], (uint8_t *)&g_acpi_tbl + offset, count);
+	send_to_host(res, count + 1);
 }
 
-static void smchost_cmd_handler(uint8_t command)
+/**
+ * @brief Write contiguous bytes into ACPI region.
+ *
+ * host_req[1] is the offset, host_req[2] the number of bytes followed by
+ * the data. Write is discarded unless every offset in range is writable,
+ * response is a status byte. Commands whose count exceeds the buffer are
+ * dispatched without data and get SMCHOST_ACPI_BLOCK_INVALID.
+ */
+static void write_acpi_block(void)
 {
-	switch (command) {
+	uint8_t offset = host_req[1];
+	uint8_t count = host_req[2];
+	uint8_t status = SMCHOST_ACPI_BLOCK_OK;
 
-	/* Handlers for commands 00h to 0Fh */
-#ifdef CONFIG_DEPRECATED_SMCHOST_CMD
-	case SMCHOST_QUERY_SYSTEM_STS:
-#endif
-	case SMCHOST_GET_PSR_SHUTDOWN_REASON:
-	case SMCHOST_GET_SMC_MODE:
-	case SMCHOST_GET_SWITCH_STS:
-	case SMCHOST_GET_FAB_ID:
-	case SMCHOST_GET_DOCK_STS:
-	case SMCHOST_READ_REVISION:
-	case SMCHOST_READ_PLAT_SIGNATURE:
-	case SMCHOST_HID_BTN_SCI_CONTROL:
-		smchost_cmd_info_handler(command);
-		break;
-	case SMCHOST_PLN_CONFIG:
-	case SMCHOST_CS_LOW_PWR_MODE_SET:
-	case SMCHOST_SET_DSW_MODE:
-	case SMCHOST_GET_DSW_MODE:
-	case SMCHOST_PG3_SET_MODE:
-	case SMCHOST_PG3_PROG_COUNTER:
-	case SMCHOST_CS_ENTRY:
-	case SMCHOST_CS_EXIT:
-	case SMCHOST_GET_LEGACY_WAKE_STS:
-	case SMCHOST_CLEAR_LEGACY_WAKE_STS:
-	case SMCHOST_SX_ENTRY:
-	case SMCHOST_SX_EXIT:
-	case SMCHOST_ENABLE_PWR_BTN_NOTIFY:
-	case SMCHOST_DISABLE_PWR_BTN_NOTIFY:
-	case SMCHOST_ENABLE_PWR_BTN_SW:
-	case SMCHOST_DISABLE_PWR_BTN_SW:
-	case SMCHOST_RESET_KSC:
-#ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
-	case SMCHOST_DNX_TRIGGER:
-	case SMCHOST_DNX_SET_STRAP:
-#endif
-		smchost_cmd_pm_handler(command);
-		break;
+	if (!acpi_block_valid(offset, count)) {
+		status = SMCHOST_ACPI_BLOCK_INVALID;
+		send_to_host(&status, 1);
+		return;
+	}
 
-#ifdef CONFIG_THERMAL_MANAGEMENT
-	case SMCHOST_UPDATE_PWM:
-	case SMCHOST_BIOS_FAN_CONTROL:
-	case SMCHOST_SET_SHDWN_THRESHOLD:
-	case SMCHOST_SET_OS_ACTIVE_TRIP:
-	case SMCHOST_GET_HW_PERIPHERALS_STS:
-		smchost_cmd_thermal_handler(command);
-		break;
-#endif
-	/* Handlers for commands 80h to 8Fh */
-	case SMCHOST_ACPI_READ:
-		acpi_read_ec();
-		break;
-	case SMCHOST_ACPI_WRITE:
-		acpi_write_ec();
-		break;
-	case SMCHOST_ACPI_BURST_MODE:
-		acpi_burst_ec();
-		break;
-	case SMCHOST_ACPI_NORMAL_MODE:
-		acpi_normal_ec();
-		break;
-	case SMCHOST_ACPI_QUERY:
-		acpi_query_ec();
-		break;
-
-	/* Handlers for commands A0h to AFh */
-	case SMCHOST_ENABLE_ACPI:
-		enable_acpi();
-		break;
-	case SMCHOST_DISABLE_ACPI:
-		disable_acpi();
-		break;
-
-	/* Handler for command 3Ch */
-#ifdef CONFIG_THERMAL_MANAGEMENT
-	case SMCHOST_SET_PECI_ACCESS_MODE:
-		change_peci_access_mode();
-		break;
-#endif
-	/* Handlers for commands E0h to EFh */
-	case SMCHOST_READ_ACPI_SPACE:
-		read_acpi_space();
-		break;
-	case SMCHOST_WRITE_ACPI_SPACE:
-		write_acpi_space();
-		break;
-	default:
-		host_cmd_default(command);
-		break;
+	for (uint8_t i = 0; i < count; i++) {
+		if (!smc_is_acpi_offset_write_permitted(offset + i)) {
+			LOG_WRN("ACPI WR not permitted at offset: %02x",
+				offset + i);
+			status = SMCHOST_ACPI_BLOCK_DENIED;
+			send_to_host(&status, 1);
+			return;
+		}
 	}
-}
 
-static void handle_kb_backlight_pwm(void)
-{
-	if (prev_kb_bklt_pwm_duty != g_acpi_tbl.kb_bklt_pwm_duty) {
-		led_blink(LED_KBD_BKLT, g_acpi_tbl.kb_bklt_pwm_duty);
-		prev_kb_bklt_pwm_duty = g_acpi_tbl.kb_bklt_pwm_duty;
+	for (uint8_t i = 0; i < count; i++) {
+		smc_acpi_write(offset + i, host_req[3 + i]);
 	}
-}
 
+	send_to_host(&status, 1);
+}
 
+/* ACPI EC protocol commands are served in every power state, OS EC driver
+ * waits for their handshake until its transaction timeout otherwise.
+ */
+SMCHOST_CMD_DEFINE(SMCHOST_ACPI_READ, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   acpi_read_ec);
+SMCHOST_CMD_DEFINE(SMCHOST_ACPI_WRITE, 2, SMCHOST_CMD_PWR_ANY, 0,
+		   acpi_write_ec);
+SMCHOST_CMD_DEFINE(SMCHOST_ACPI_BURST_MODE, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   acpi_burst_ec);
+SMCHOST_CMD_DEFINE(SMCHOST_ACPI_NORMAL_MODE, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   acpi_normal_ec);
+SMCHOST_CMD_DEFINE(SMCHOST_ACPI_QUERY, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   acpi_query_ec);
+SMCHOST_CMD_DEFINE(SMCHOST_ENABLE_ACPI, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   enable_acpi);
+SMCHOST_CMD_DEFINE(SMCHOST_DISABLE_ACPI, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   disable_acpi);
+SMCHOST_CMD_DEFINE(SMCHOST_READ_ACPI_SPACE, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   read_acpi_space);
+SMCHOST_CMD_DEFINE(SMCHOST_WRITE_ACPI_SPACE, 2, SMCHOST_CMD_PWR_ANY, 0,
+		   write_acpi_space);
+SMCHOST_CMD_DEFINE(SMCHOST_READ_ACPI_BLOCK, 2, SMCHOST_CMD_PWR_ANY, 0,
+		   read_acpi_block);
+SMCHOST_CMD_DEFINE(SMCHOST_WRITE_ACPI_BLOCK, 2, SMCHOST_CMD_PWR_ANY,
+		   SMCHOST_CMD_FLAG_VAR_LEN, write_acpi_block);
+
+static void handle_kb_backlight_pwm(uint8_t offset)
+{
+	led_blink(LED_KBD_BKLT, g_acpi_tbl.kb_bklt_pwm_duty);
+}
+
+SMC_ACPI_SUBSCRIBE(acpi_sub_host_command, acpi_host_command,
+		   service_system_acpi_cmds);
+SMC_ACPI_SUBSCRIBE(acpi_sub_kb_bklt, kb_bklt_pwm_duty,
+		   handle_kb_backlight_pwm);
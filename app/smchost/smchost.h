@@ -34,8 +34,16 @@
 #define LEGACY_PECI_MODE 0
 #define PECI_OVER_ESPI_MODE 1
 
+/* Maximum bytes transferred by ACPI space block commands */
+#define SMCHOST_ACPI_BLOCK_MAX		32
+
+/* Status byte leading ACPI space block command responses */
+#define SMCHOST_ACPI_BLOCK_OK		0x00
+#define SMCHOST_ACPI_BLOCK_INVALID	0x01
+#define SMCHOST_ACPI_BLOCK_DENIED	0x02
+
 /* EC identifier */
-#define SMCHOST_MAX_BUF_SIZE		10
+#define SMCHOST_MAX_BUF_SIZE		(SMCHOST_ACPI_BLOCK_MAX + 3)
 
 /* Virtual Dock Status */
 #define VIRTUAL_DOCK_CONNECTED 0
@@ -71,6 +79,20 @@ void smchost_thread(void *p1, void *p2, void *p3);
  */
 void send_to_host(uint8_t *pdata, uint8_t len);
 
+#ifdef CONFIG_SMCHOST_ACPI_BENCH
+/**
+ * @brief ACPI EC throughput benchmark.
+ *
+ * Emulates OS ACPI EC driver sequences against the ACPI EC emulator and logs
+ * transactions per second and latency percentiles.
+ *
+ * @param p1 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ */
+void smchost_bench_thread(void *p1, void *p2, void *p3);
+#endif
+
 #ifdef CONFIG_SMCHOST_EVENT_DRIVEN_TASK
 /**
  * @brief Indicate smchost task there is an event that requires to be processed.
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "acpi_emul.h"
+#include "acpi_region.h"
+#include "bench.h"
+#include "scicodes.h"
+#include "smchost.h"
+#include "smchost_commands.h"
+
+LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
+
+/* Scratch area written by the EC_WRITE sequence, SMBus data block is only
+ * consumed once the protocol register is written.
+ */
+#define BENCH_WR_OFFSET		offsetof(struct acpi_tbl, acpi_smb.data)
+#define BENCH_WR_SIZE		sizeof(g_acpi_tbl.acpi_smb.data)
+
+enum bench_seq {
+	BENCH_SEQ_READ,
+	BENCH_SEQ_WRITE,
+	BENCH_SEQ_QUERY,
+	BENCH_SEQ_BURST,
+	BENCH_SEQ_TOTAL,
+};
+
+static const char * const bench_seq_name[BENCH_SEQ_TOTAL] = {
+	"EC_READ",
+	"EC_WRITE",
+	"QUERY",
+	"BURST",
+};
+
+/* ACPI EC transactions in each step, burst adds enable and disable */
+static const uint8_t bench_seq_txns[BENCH_SEQ_TOTAL] = {
+	1,
+	1,
+	1,
+	BENCH_WR_SIZE + 2,
+};
+
+static uint32_t samples[CONFIG_SMCHOST_ACPI_BENCH_ITERATIONS];
+
+static uint8_t host_read_sts(void)
+{
+	return acpi_emul_host_read_sts(ACPI_EC_0);
+}
+
+/* Wait until the status flag reaches the expected value like OS does */
+static int host_wait(uint8_t flag, bool set)
+{
+	return bench_wait_sts(host_read_sts, flag, set, BENCH_TIMEOUT_US);
+}
+
+static int host_cmd(uint8_t cmd)
+{
+	if (host_wait(ACPI_FLAG_IBF, false)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_write_cmd(ACPI_EC_0, cmd);
+}
+
+static int host_data(uint8_t data)
+{
+	if (host_wait(ACPI_FLAG_IBF, false)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_write_data(ACPI_EC_0, data);
+}
+
+static int host_read(uint8_t *data)
+{
+	if (host_wait(ACPI_FLAG_OBF, true)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_read_data(ACPI_EC_0, data);
+}
+
+static int ec_read(uint8_t offset, uint8_t *data)
+{
+	int ret;
+
+	ret = host_cmd(EC_READ);
+	if (!ret) {
+		ret = host_data(offset);
+	}
+
+	if (!ret) {
+		ret = host_read(data);
+	}
+
+	return ret;
+}
+
+static int ec_write(uint8_t offset, uint8_t data)
+{
+	int ret;
+
+	ret = host_cmd(EC_WRITE);
+	if (!ret) {
+		ret = host_data(offset);
+	}
+
+	if (!ret) {
+		ret = host_data(data);
+	}
+
+	if (!ret) {
+		ret = host_wait(ACPI_FLAG_IBF, false);
+	}
+
+	return ret;
+}
+
+static int ec_query(void)
+{
+	uint8_t code;
+	int ret;
+
+	ret = host_cmd(EC_QUERY);
+	if (!ret) {
+		ret = host_read(&code);
+	}
+
+	return ret;
+}
+
+/* Read a block of the ACPI region while the EC is held in burst mode */
+static int ec_burst_read(uint8_t offset)
+{
+	uint8_t ack;
+	uint8_t data;
+	int ret;
+
+	ret = host_cmd(EC_BURST);
+	if (!ret) {
+		ret = host_read(&ack);
+	}
+
+	if (!ret && ack != SCI_BURST_ACK) {
+		ret = -EIO;
+	}
+
+	for (int i = 0; !ret && i < BENCH_WR_SIZE; i++) {
+		ret = ec_read(offset + i, &data);
+	}
+
+	if (!ret) {
+		ret = host_cmd(EC_NORM);
+	}
+
+	if (!ret) {
+		ret = host_wait(ACPI_FLAG_IBF, false);
+	}
+
+	return ret;
+}
+
+static int bench_step(enum bench_seq seq, uint32_t i)
+{
+	uint8_t offset = BENCH_WR_OFFSET + (i % BENCH_WR_SIZE);
+	uint8_t data;
+
+	switch (seq) {
+	case BENCH_SEQ_READ:
+		return ec_read(i % (ACPI_MAX_INDEX + 1), &data);
+	case BENCH_SEQ_WRITE:
+		return ec_write(offset, (uint8_t)i);
+	case BENCH_SEQ_QUERY:
+		return ec_query();
+	case BENCH_SEQ_BURST:
+		return ec_burst_read(BENCH_WR_OFFSET);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int bench_iter_step(uint32_t i, struct bench_samples *lat, void *ctx)
+{
+	enum bench_seq seq = (enum bench_seq)(uintptr_t)ctx;
+	uint32_t start = k_cycle_get_32();
+	int ret;
+
+	ret = bench_step(seq, i);
+	if (!ret) {
+		bench_sample_add(lat,
+				 k_cyc_to_us_floor32(k_cycle_get_32() - start));
+	}
+
+	return ret;
+}
+
+/* Returns true if the sequence meets the pass criteria */
+static bool bench_seq_run(enum bench_seq seq)
+{
+	struct bench_samples s = {
+		.buf = samples,
+		.size = ARRAY_SIZE(samples),
+	};
+	struct bench_result res;
+
+	bench_run(bench_iter_step, (void *)(uintptr_t)seq,
+		  CONFIG_SMCHOST_ACPI_BENCH_ITERATIONS, &s, &res);
+
+	if (!res.samples) {
+		LOG_ERR("%s: all %u transactions failed", bench_seq_name[seq],
+			res.errors);
+		return false;
+	}
+
+	LOG_INF("%s: %u tps p50 %u us p99 %u us max %u us errors %u",
+		bench_seq_name[seq], res.per_sec, res.p50_us, res.p99_us,
+		res.max_us, res.errors);
+
+	return !res.errors && res.p99_us <=
+	       CONFIG_SMCHOST_ACPI_BENCH_P99_MAX_US * bench_seq_txns[seq];
+}
+
+void smchost_bench_thread(void *p1, void *p2, void *p3)
+{
+	bool pass = true;
+
+	if (host_cmd(SMCHOST_ENABLE_ACPI)) {
+		LOG_ERR("EC not responding");
+		LOG_INF("ACPI bench: FAIL");
+		return;
+	}
+
+	for (int seq = 0; seq < BENCH_SEQ_TOTAL; seq++) {
+		if (!bench_seq_run(seq)) {
+			LOG_ERR("%s: exceeds p99 %u us or has errors",
+				bench_seq_name[seq],
+				CONFIG_SMCHOST_ACPI_BENCH_P99_MAX_US *
+				bench_seq_txns[seq]);
+			pass = false;
+		}
+	}
+
+	LOG_INF("ACPI bench: %s", pass ? "PASS" : "FAIL");
+}
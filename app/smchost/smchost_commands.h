@@ -12,6 +12,9 @@
 #ifndef __SMCHOST_COMMANDS_H__
 #define __SMCHOST_COMMANDS_H__
 
+#include <zephyr/sys/iterable_sections.h>
+#include "system.h"
+
 #define SMCHOST_GET_SMC_MODE		0x09
 #define SMCHOST_GET_SWITCH_STS		0x0A
 #define SMCHOST_GET_PSR_SHUTDOWN_REASON 0x0C
@@ -48,6 +51,8 @@
 #define SMCHOST_ENABLE_SMI		0xBD
 #define SMCHOST_READ_ACPI_SPACE		0xEA
 #define SMCHOST_WRITE_ACPI_SPACE	0xEB
+#define SMCHOST_READ_ACPI_BLOCK		0xEC
+#define SMCHOST_WRITE_ACPI_BLOCK	0xED
 #define SMCHOST_RESET_KSC		0xFF
 #ifdef CONFIG_DEPRECATED_SMCHOST_CMD
 #define SMCHOST_QUERY_SYSTEM_STS	0x06
@@ -60,10 +65,67 @@
 #define SMCHOST_SET_SHDWN_THRESHOLD	0x58
 #define SMCHOST_BIOS_FAN_CONTROL	0xFE
 #endif
+#ifdef CONFIG_SMCHOST_ACPI_LATENCY
+#define SMCHOST_GET_ACPI_LATENCY	0x3D
+#endif
 #ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
 #define SMCHOST_DNX_TRIGGER		0xF6
 #define SMCHOST_DNX_SET_STRAP		0xF7
 #endif
 
+/* Power states in which a host command is permitted */
+#define SMCHOST_CMD_PWR_S0		BIT(SYSTEM_S0_STATE)
+#define SMCHOST_CMD_PWR_ANY		(BIT(SYSTEM_G3_STATE) | \
+					 BIT(SYSTEM_S0_STATE) | \
+					 BIT(SYSTEM_S3_STATE) | \
+					 BIT(SYSTEM_S4_STATE) | \
+					 BIT(SYSTEM_S5_STATE))
+
+/* Host command is only accepted when system is in ACPI mode */
+#define SMCHOST_CMD_FLAG_ACPI_MODE	BIT(0)
+/* Last of the req_len bytes indicates the number of data bytes that follow */
+#define SMCHOST_CMD_FLAG_VAR_LEN	BIT(1)
+
+/**
+ * @brief Host command descriptor.
+ *
+ * Each module registers the host commands it handles using
+ * @ref SMCHOST_CMD_DEFINE, smchost dispatches them through a lookup table
+ * indexed by command code.
+ */
+struct smchost_cmd {
+	/* Command code as sent by the host */
+	uint8_t command;
+	/* Number of data bytes following the command code, for variable
+	 * length commands only the header including the byte count.
+	 */
+	uint8_t req_len;
+	/* Bitmask of system power states where command is permitted */
+	uint8_t pwr_states;
+	/* Additional command requirements */
+	uint8_t flags;
+	/* Performs the operation once all data bytes are received */
+	void (*handler)(void);
+};
+
+/**
+ * @brief Register a host command handler.
+ *
+ * @param _cmd command code.
+ * @param _len number of data bytes following the command code.
+ * @param _pwr_states bitmask of power states where command is permitted.
+ * @param _flags additional command requirements.
+ * @param _handler function called once all data bytes are received.
+ */
+#define SMCHOST_CMD_DEFINE(_cmd, _len, _pwr_states, _flags, _handler)	\
+	static const STRUCT_SECTION_ITERABLE(smchost_cmd,		\
+					     smchost_cmd_##_cmd) = {	\
+		.command = _cmd,					\
+		.req_len = _len,					\
+		.pwr_states = _pwr_states,				\
+		.flags = _flags,					\
+		.handler = _handler,					\
+	}
+
 #endif /* __SMCHOST_COMMANDS_H__ */
 
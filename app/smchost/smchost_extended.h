@@ -8,29 +8,6 @@
 #define __SMCHOST_EXTENDED_H__
 
 
-/**
- * @brief Handle extended SMC commands to retrieve EC information.
- *
- * @param command identifier for the operation requested.
- */
-void smchost_cmd_info_handler(uint8_t command);
-
-/**
- * @brief Handle extended SMC commands for power management operations.
- *
- * @param command identifier for the operation requested.
- */
-void smchost_cmd_pm_handler(uint8_t command);
-
-#ifdef CONFIG_THERMAL_MANAGEMENT
-/**
- * @brief Handle extended SMC commands for thermal management.
- *
- * @param command identifier for the operation requested.
- */
-void smchost_cmd_thermal_handler(uint8_t command);
-#endif
-
 /**
  * @brief Handle power button events.
  *
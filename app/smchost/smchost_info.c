@@ -158,42 +158,25 @@ static void get_shutdown_reason(void)
 	uint8_t shutdown_status = read_shutdown_reason();
 
 	send_to_host((uint8_t *)&shutdown_status, sizeof(shutdown_status));
-}
 
+	/* Clear shutodown reason */
+	set_shutdown_reason(SHUTDOWN_REASON_DEFAULT);
+}
 
-void smchost_cmd_info_handler(uint8_t command)
-{
-	switch (command) {
 #ifdef CONFIG_DEPRECATED_SMCHOST_CMD
-	case SMCHOST_QUERY_SYSTEM_STS:
-		query_system_status();
-		break;
+SMCHOST_CMD_DEFINE(SMCHOST_QUERY_SYSTEM_STS, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   query_system_status);
 #endif
-	case SMCHOST_GET_PSR_SHUTDOWN_REASON:
-		get_shutdown_reason();
-		/* Clear shutodown reason */
-		set_shutdown_reason(SHUTDOWN_REASON_DEFAULT);
-		break;
-	case SMCHOST_GET_SMC_MODE:
-		smc_mode();
-		break;
-	case SMCHOST_GET_SWITCH_STS:
-		get_switch_status();
-		break;
-	case SMCHOST_GET_FAB_ID:
-		smc_get_fab_id();
-		break;
-	case SMCHOST_READ_PLAT_SIGNATURE:
-		read_platform_signature();
-		break;
-	case SMCHOST_READ_REVISION:
-		read_revision();
-		break;
-	case SMCHOST_HID_BTN_SCI_CONTROL:
-		btn_sci_cntrl();
-		break;
-	default:
-		LOG_WRN("%s: command 0x%X without handler", __func__, command);
-		break;
-	}
-}
+SMCHOST_CMD_DEFINE(SMCHOST_GET_PSR_SHUTDOWN_REASON, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   get_shutdown_reason);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_SMC_MODE, 0, SMCHOST_CMD_PWR_ANY, 0, smc_mode);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_SWITCH_STS, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   get_switch_status);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_FAB_ID, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   smc_get_fab_id);
+SMCHOST_CMD_DEFINE(SMCHOST_READ_PLAT_SIGNATURE, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   read_platform_signature);
+SMCHOST_CMD_DEFINE(SMCHOST_READ_REVISION, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   read_revision);
+SMCHOST_CMD_DEFINE(SMCHOST_HID_BTN_SCI_CONTROL, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   btn_sci_cntrl);
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
+#include "smchost.h"
+#include "smchost_commands.h"
+#include "smchost_latency.h"
+#include "lat_hist.h"
+
+LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
+
+/* 16-bit values and histogram buckets per SMCHOST_GET_ACPI_LATENCY page */
+#define LAT_PAGE_WORDS		5u
+#define LAT_BUCKETS_PER_PAGE	LAT_PAGE_WORDS
+
+struct acpi_lat_entry {
+	bool used;
+	uint8_t command;
+	uint16_t samples;
+	uint16_t max_us;
+	uint16_t stage_max_us[ACPI_LAT_STAGES];
+	uint16_t hist[ACPI_LAT_BUCKETS];
+};
+
+/* Transaction in progress */
+struct acpi_lat_trans {
+	bool active;
+	uint8_t command;
+	uint8_t stages;
+	uint32_t start;
+	uint32_t stage_us[ACPI_LAT_STAGES];
+};
+
+static struct k_spinlock lat_lock;
+static struct acpi_lat_trans trans;
+static struct acpi_lat_entry lat_tbl[CONFIG_SMCHOST_ACPI_LATENCY_CMDS];
+
+/* Transactions not accounted because all entries are in use */
+static uint32_t lat_untracked;
+
+static struct acpi_lat_entry *lat_find(uint8_t command, bool alloc)
+{
+	for (int i = 0; i < ARRAY_SIZE(lat_tbl); i++) {
+		if (lat_tbl[i].used && lat_tbl[i].command == command) {
+			return &lat_tbl[i];
+		}
+	}
+
+	if (!alloc) {
+		return NULL;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(lat_tbl); i++) {
+		if (!lat_tbl[i].used) {
+			lat_tbl[i].used = true;
+			lat_tbl[i].command = command;
+			return &lat_tbl[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be called with lat_lock held */
+static void lat_account(void)
+{
+	struct acpi_lat_entry *entry;
+	uint32_t total = 0;
+
+	/* Rejected commands never reach dispatch */
+	if (!trans.active || !(trans.stages & BIT(ACPI_LAT_DISPATCH))) {
+		trans.active = false;
+		return;
+	}
+
+	trans.active = false;
+	entry = lat_find(trans.command, true);
+	if (!entry) {
+		lat_untracked++;
+		return;
+	}
+
+	for (int i = 0; i < ACPI_LAT_STAGES; i++) {
+		if (!(trans.stages & BIT(i))) {
+			continue;
+		}
+
+		entry->stage_max_us[i] = MAX(entry->stage_max_us[i],
+					     lat_sat_u16(trans.stage_us[i]));
+		total = MAX(total, trans.stage_us[i]);
+	}
+
+	lat_hist_add(entry->hist, ACPI_LAT_BUCKETS, total);
+	lat_sat_inc(&entry->samples);
+	entry->max_us = MAX(entry->max_us, lat_sat_u16(total));
+}
+
+void acpi_lat_start(uint8_t command)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+	/* Transaction abandoned by the host before its completion */
+	lat_account();
+
+	trans.active = true;
+	trans.command = command;
+	trans.stages = 0;
+	trans.start = k_cycle_get_32();
+
+	k_spin_unlock(&lat_lock, key);
+}
+
+void acpi_lat_mark(enum acpi_lat_stage stage)
+{
+	uint32_t now = k_cycle_get_32();
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+	if (trans.active && !(trans.stages & BIT(stage))) {
+		trans.stages |= BIT(stage);
+		trans.stage_us[stage] = k_cyc_to_us_floor32(now - trans.start);
+	}
+
+	k_spin_unlock(&lat_lock, key);
+}
+
+void acpi_lat_end(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+	lat_account();
+	k_spin_unlock(&lat_lock, key);
+}
+
+/**
+ * @brief Report latency statistics for a host command.
+ *
+ * host_req[1] is the command code and host_req[2] the page requested.
+ * Page 0 returns samples, overall max and per stage max as 16-bit values,
+ * following pages return the histogram buckets.
+ * Commands that were not measured report all zeroes.
+ */
+static void get_acpi_latency(void)
+{
+	uint16_t res[LAT_PAGE_WORDS] = { 0 };
+	struct acpi_lat_entry *entry;
+	uint8_t page = host_req[2];
+	k_spinlock_key_t key;
+	uint32_t first;
+
+	key = k_spin_lock(&lat_lock);
+	entry = lat_find(host_req[1], false);
+	if (entry && page == 0) {
+		res[0] = entry->samples;
+		res[1] = entry->max_us;
+		for (int i = 0; i < ACPI_LAT_STAGES; i++) {
+			res[2 + i] = entry->stage_max_us[i];
+		}
+	} else if (entry) {
+		first = (page - 1) * LAT_BUCKETS_PER_PAGE;
+		for (int i = 0; i < LAT_BUCKETS_PER_PAGE; i++) {
+			if (first + i < ACPI_LAT_BUCKETS) {
+				res[i] = entry->hist[first + i];
+			}
+		}
+	}
+	k_spin_unlock(&lat_lock, key);
+
+	send_to_host((uint8_t *)res, sizeof(res));
+}
+
+SMCHOST_CMD_DEFINE(SMCHOST_GET_ACPI_LATENCY, 2, SMCHOST_CMD_PWR_ANY, 0,
+		   get_acpi_latency);
+
+#ifdef CONFIG_SHELL
+static int cmd_latency_show(const struct shell *sh, size_t argc, char **argv)
+{
+	struct acpi_lat_entry entry;
+	k_spinlock_key_t key;
+
+	for (int i = 0; i < ARRAY_SIZE(lat_tbl); i++) {
+		key = k_spin_lock(&lat_lock);
+		entry = lat_tbl[i];
+		k_spin_unlock(&lat_lock, key);
+
+		if (!entry.used) {
+			continue;
+		}
+
+		shell_print(sh, "cmd %02X samples %u max %u us", entry.command,
+			    entry.samples, entry.max_us);
+		shell_print(sh, "  dispatch %u us obf %u us sci %u us",
+			    entry.stage_max_us[ACPI_LAT_DISPATCH],
+			    entry.stage_max_us[ACPI_LAT_OBF],
+			    entry.stage_max_us[ACPI_LAT_SCI]);
+		lat_hist_print(sh, entry.hist, ACPI_LAT_BUCKETS);
+	}
+
+	shell_print(sh, "untracked %u", lat_untracked);
+
+	return 0;
+}
+
+static int cmd_latency_clear(const struct shell *sh, size_t argc,
+			     char **argv)
+{
+	k_spinlock_key_t key = k_spin_lock(&lat_lock);
+
+	memset(lat_tbl, 0, sizeof(lat_tbl));
+	lat_untracked = 0;
+	trans.active = false;
+
+	k_spin_unlock(&lat_lock, key);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_latency,
+	SHELL_CMD(show, NULL, "Show ACPI transaction latency",
+		  cmd_latency_show),
+	SHELL_CMD(clear, NULL, "Clear ACPI transaction latency",
+		  cmd_latency_clear),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_smchost,
+	SHELL_CMD(latency, &sub_latency, "ACPI transaction latency", NULL),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(smchost, &sub_smchost, "SMC host commands", NULL);
+#endif
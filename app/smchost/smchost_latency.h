@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief APIs to measure ACPI EC transaction latency.
+ */
+
+#ifndef __SMCHOST_LATENCY_H__
+#define __SMCHOST_LATENCY_H__
+
+#include <stdint.h>
+
+/* Milestones of an ACPI EC transaction measured from command IBF */
+enum acpi_lat_stage {
+	ACPI_LAT_DISPATCH,
+	ACPI_LAT_OBF,
+	ACPI_LAT_SCI,
+	ACPI_LAT_STAGES,
+};
+
+/* Histogram buckets, bucket n holds samples in [2^(n-1), 2^n) us */
+#define ACPI_LAT_BUCKETS		15u
+
+#ifdef CONFIG_SMCHOST_ACPI_LATENCY
+/**
+ * @brief Start timing a host transaction.
+ *
+ * Called when the command byte is read from the input buffer, a previous
+ * transaction the host abandoned is accounted before starting the new one.
+ *
+ * @param command command code sent by the host.
+ */
+void acpi_lat_start(uint8_t command);
+
+/**
+ * @brief Record a milestone for the transaction in progress.
+ *
+ * Only the first occurrence of each stage within a transaction is recorded.
+ *
+ * @param stage the transaction milestone reached.
+ */
+void acpi_lat_mark(enum acpi_lat_stage stage);
+
+/**
+ * @brief Account the transaction in progress.
+ *
+ * Called once the transaction completes, when the last response byte is
+ * written to the output buffer, or on dispatch for commands without
+ * response. Does nothing if no transaction is in progress.
+ */
+void acpi_lat_end(void);
+#else
+static inline void acpi_lat_start(uint8_t command) {}
+static inline void acpi_lat_mark(enum acpi_lat_stage stage) {}
+static inline void acpi_lat_end(void) {}
+#endif
+
+#endif /* __SMCHOST_LATENCY_H__ */
@@ -22,9 +22,6 @@
 #include "pseudog3.h"
 #include "kbchost.h"
 #include "espi_hub.h"
-#ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
-#include "dnx_ec_assisted_trigger.h"
-#endif
 LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
 static bool pwrbtn_notify;
@@ -255,73 +252,56 @@ static void clear_legacy_wake_sts(void)
 	legacy_wake_status = 0;
 }
 
-void smchost_cmd_pm_handler(uint8_t command)
+static void enable_pwrbtn_notify(void)
 {
-	switch (command) {
-	case SMCHOST_PLN_CONFIG:
-		config_ssd_pln();
-		break;
-	case SMCHOST_ENABLE_PWR_BTN_NOTIFY:
-		pwrbtn_notify = true;
-		break;
-	case SMCHOST_DISABLE_PWR_BTN_NOTIFY:
-		pwrbtn_notify = false;
-		break;
-	case SMCHOST_ENABLE_PWR_BTN_SW:
-		g_pwrflags.pwr_sw_enabled = 1;
-		break;
-	case SMCHOST_DISABLE_PWR_BTN_SW:
-		g_pwrflags.pwr_sw_enabled = 0;
-		break;
-	case SMCHOST_GET_LEGACY_WAKE_STS:
-		get_legacy_wake_sts();
-		break;
-	case SMCHOST_CLEAR_LEGACY_WAKE_STS:
-		clear_legacy_wake_sts();
-		break;
-	case SMCHOST_SX_ENTRY:
-		sx_entry();
-		break;
-	case SMCHOST_SX_EXIT:
-		sx_exit();
-		break;
-	case SMCHOST_SET_DSW_MODE:
-		change_dsw_mode();
-		break;
-	case SMCHOST_GET_DSW_MODE:
-		retrieve_dsw_mode();
-		break;
-	case SMCHOST_PG3_SET_MODE:
-		change_pg3_mode();
-		break;
-	case SMCHOST_PG3_PROG_COUNTER:
-		pg3_prog_counter();
-		break;
-	case SMCHOST_CS_LOW_PWR_MODE_SET:
-		enable_cs_lpm_mode();
-		break;
-	case SMCHOST_CS_ENTRY:
-		cs_entry();
-		break;
-	case SMCHOST_CS_EXIT:
-		cs_exit();
-		break;
-#ifdef CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC
-	/* Set DnX strap and trigger cold restart, requires eSPI OOB support */
-	case SMCHOST_DNX_TRIGGER:
-		dnx_soc_handshake();
-		dnx_ec_assisted_restart();
-		break;
-	/* Set DnX strap only, requires manual restart */
-	case SMCHOST_DNX_SET_STRAP:
-		dnx_soc_handshake();
-		break;
-#endif /* CONFIG_DNX_EC_ASSISTED_TRIGGER_SMC */
-	case SMCHOST_RESET_KSC:
-		ec_reset();
-		break;
-	default:
-		LOG_WRN("%s: command 0x%X without handler", __func__, command);
-		break;
-	}
+	pwrbtn_notify = true;
+}
+
+static void disable_pwrbtn_notify(void)
+{
+	pwrbtn_notify = false;
 }
+
+static void enable_pwrbtn_sw(void)
+{
+	g_pwrflags.pwr_sw_enabled = 1;
+}
+
+static void disable_pwrbtn_sw(void)
+{
+	g_pwrflags.pwr_sw_enabled = 0;
+}
+
+SMCHOST_CMD_DEFINE(SMCHOST_PLN_CONFIG, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   config_ssd_pln);
+SMCHOST_CMD_DEFINE(SMCHOST_ENABLE_PWR_BTN_NOTIFY, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   enable_pwrbtn_notify);
+SMCHOST_CMD_DEFINE(SMCHOST_DISABLE_PWR_BTN_NOTIFY, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   disable_pwrbtn_notify);
+SMCHOST_CMD_DEFINE(SMCHOST_ENABLE_PWR_BTN_SW, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   enable_pwrbtn_sw);
+SMCHOST_CMD_DEFINE(SMCHOST_DISABLE_PWR_BTN_SW, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   disable_pwrbtn_sw);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_LEGACY_WAKE_STS, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   get_legacy_wake_sts);
+SMCHOST_CMD_DEFINE(SMCHOST_CLEAR_LEGACY_WAKE_STS, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   clear_legacy_wake_sts);
+SMCHOST_CMD_DEFINE(SMCHOST_SX_ENTRY, 0, SMCHOST_CMD_PWR_ANY, 0, sx_entry);
+SMCHOST_CMD_DEFINE(SMCHOST_SX_EXIT, 0, SMCHOST_CMD_PWR_ANY, 0, sx_exit);
+SMCHOST_CMD_DEFINE(SMCHOST_SET_DSW_MODE, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   change_dsw_mode);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_DSW_MODE, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   retrieve_dsw_mode);
+SMCHOST_CMD_DEFINE(SMCHOST_PG3_SET_MODE, 1, SMCHOST_CMD_PWR_ANY, 0,
+		   change_pg3_mode);
+SMCHOST_CMD_DEFINE(SMCHOST_PG3_PROG_COUNTER, 0, SMCHOST_CMD_PWR_ANY, 0,
+		   pg3_prog_counter);
+/* Connected standby is an S0 substate entered by the OS in ACPI mode. Exit
+ * only requires S0 so the standby state is always cleared on resume.
+ */
+SMCHOST_CMD_DEFINE(SMCHOST_CS_LOW_PWR_MODE_SET, 1, SMCHOST_CMD_PWR_S0, 0,
+		   enable_cs_lpm_mode);
+SMCHOST_CMD_DEFINE(SMCHOST_CS_ENTRY, 0, SMCHOST_CMD_PWR_S0,
+		   SMCHOST_CMD_FLAG_ACPI_MODE, cs_entry);
+SMCHOST_CMD_DEFINE(SMCHOST_CS_EXIT, 0, SMCHOST_CMD_PWR_S0, 0, cs_exit);
+SMCHOST_CMD_DEFINE(SMCHOST_RESET_KSC, 0, SMCHOST_CMD_PWR_ANY, 0, ec_reset);
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "i2c_hub.h"
+#include "smc.h"
+#include "sci.h"
+#include "scicodes.h"
+
+LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
+
+/* SMB_PRTCL protocol values as defined by ACPI SMBus host controller */
+#define SMB_PRTCL_NONE			0x00u
+#define SMB_PRTCL_WRITE_QUICK		0x02u
+#define SMB_PRTCL_READ_QUICK		0x03u
+#define SMB_PRTCL_SEND_BYTE		0x04u
+#define SMB_PRTCL_RECEIVE_BYTE		0x05u
+#define SMB_PRTCL_WRITE_BYTE		0x06u
+#define SMB_PRTCL_READ_BYTE		0x07u
+#define SMB_PRTCL_WRITE_WORD		0x08u
+#define SMB_PRTCL_READ_WORD		0x09u
+#define SMB_PRTCL_WRITE_BLOCK		0x0Au
+#define SMB_PRTCL_READ_BLOCK		0x0Bu
+#define SMB_PRTCL_PROCESS_CALL		0x0Cu
+#define SMB_PRTCL_BLOCK_PROCESS_CALL	0x0Du
+#define SMB_PRTCL_PEC			BIT(7)
+
+/* SMB_STS fields */
+#define SMB_STS_DONE			BIT(7)
+#define SMB_STS_ALRM			BIT(6)
+#define SMB_STS_OK			0x00u
+#define SMB_STS_UNKNOWN_FAILURE		0x07u
+#define SMB_STS_DEV_NACK		0x10u
+#define SMB_STS_DEV_ERROR		0x11u
+#define SMB_STS_TIMEOUT			0x18u
+#define SMB_STS_UNSUPPORTED		0x19u
+#define SMB_STS_BUSY			0x1Au
+
+#define SMB_BLOCK_MAX		sizeof(g_acpi_tbl.acpi_smb.data)
+
+/* Snapshot of the host request, mailbox may change while bus is busy */
+struct smb_request {
+	uint8_t prtcl;
+	uint8_t addr;
+	uint8_t cmd;
+	uint8_t bcnt;
+	uint8_t data[SMB_BLOCK_MAX];
+};
+
+static struct smb_request req;
+/* Request written by host while the bus was busy */
+static struct smb_request next_req;
+static bool smb_next_pending;
+static bool smb_busy;
+static bool smb_configured;
+static struct k_spinlock smb_lock;
+
+static void smb_snapshot(struct smb_request *r)
+{
+	struct acpi_smb_hc *smb = &g_acpi_tbl.acpi_smb;
+
+	r->prtcl = smb->prtcl;
+	r->addr = smb->addr;
+	r->cmd = smb->cmd;
+	r->bcnt = smb->bcnt;
+	memcpy(r->data, smb->data, sizeof(r->data));
+}
+
+static uint8_t smb_status(int ret)
+{
+	switch (ret) {
+	case 0:
+		return SMB_STS_OK;
+	case -EIO:
+		return SMB_STS_DEV_NACK;
+	case -EAGAIN:
+	case -ETIMEDOUT:
+		return SMB_STS_TIMEOUT;
+	case -EBUSY:
+		return SMB_STS_BUSY;
+	case -ENOTSUP:
+		return SMB_STS_UNSUPPORTED;
+	case -EINVAL:
+		return SMB_STS_DEV_ERROR;
+	default:
+		return SMB_STS_UNKNOWN_FAILURE;
+	}
+}
+
+/* SMBus block reads return the byte count ahead of the data */
+static int smb_block_read(uint16_t addr, const uint8_t *wr, size_t wr_len,
+			  uint8_t *bcnt, uint8_t *data)
+{
+	uint8_t buf[SMB_BLOCK_MAX + 1];
+	int ret;
+
+	ret = i2c_hub_write_read(CONFIG_SMCHOST_SMBUS_HC_I2C_PORT, addr, wr,
+				 wr_len, buf, sizeof(buf));
+	if (ret) {
+		return ret;
+	}
+
+	if (buf[0] > SMB_BLOCK_MAX) {
+		return -EINVAL;
+	}
+
+	*bcnt = buf[0];
+	memcpy(data, &buf[1], buf[0]);
+
+	return 0;
+}
+
+/* Performs the transaction, bcnt is only updated by protocols reading data */
+static int smb_execute(struct smb_request *r, uint8_t *bcnt, uint8_t *data)
+{
+	uint8_t port = CONFIG_SMCHOST_SMBUS_HC_I2C_PORT;
+	uint16_t addr = r->addr >> 1;
+	uint8_t buf[SMB_BLOCK_MAX + 2];
+	uint8_t len;
+
+	buf[0] = r->cmd;
+
+	switch (r->prtcl) {
+	case SMB_PRTCL_WRITE_QUICK:
+		return i2c_hub_write(port, buf, 0, addr);
+	case SMB_PRTCL_SEND_BYTE:
+		return i2c_hub_write(port, buf, 1, addr);
+	case SMB_PRTCL_RECEIVE_BYTE:
+		*bcnt = 1;
+		return i2c_hub_read(port, data, 1, addr);
+	case SMB_PRTCL_WRITE_BYTE:
+	case SMB_PRTCL_WRITE_WORD:
+		len = (r->prtcl == SMB_PRTCL_WRITE_BYTE) ? 1 : 2;
+		memcpy(&buf[1], r->data, len);
+		return i2c_hub_write(port, buf, len + 1, addr);
+	case SMB_PRTCL_READ_BYTE:
+	case SMB_PRTCL_READ_WORD:
+		*bcnt = (r->prtcl == SMB_PRTCL_READ_BYTE) ? 1 : 2;
+		return i2c_hub_write_read(port, addr, buf, 1, data, *bcnt);
+	case SMB_PRTCL_PROCESS_CALL:
+		*bcnt = 2;
+		memcpy(&buf[1], r->data, 2);
+		return i2c_hub_write_read(port, addr, buf, 3, data, 2);
+	case SMB_PRTCL_WRITE_BLOCK:
+		if (r->bcnt == 0 || r->bcnt > SMB_BLOCK_MAX) {
+			return -EINVAL;
+		}
+
+		buf[1] = r->bcnt;
+		memcpy(&buf[2], r->data, r->bcnt);
+		return i2c_hub_write(port, buf, r->bcnt + 2, addr);
+	case SMB_PRTCL_READ_BLOCK:
+		return smb_block_read(addr, buf, 1, bcnt, data);
+	case SMB_PRTCL_BLOCK_PROCESS_CALL:
+		if (r->bcnt == 0 || r->bcnt > SMB_BLOCK_MAX) {
+			return -EINVAL;
+		}
+
+		buf[1] = r->bcnt;
+		memcpy(&buf[2], r->data, r->bcnt);
+		return smb_block_read(addr, buf, r->bcnt + 2, bcnt, data);
+	default:
+		/* Quick read and PEC can't be expressed through i2c API */
+		return -ENOTSUP;
+	}
+}
+
+static void smb_work_handler(struct k_work *work)
+{
+	struct acpi_smb_hc *smb = &g_acpi_tbl.acpi_smb;
+	uint8_t data[SMB_BLOCK_MAX];
+	uint8_t bcnt = 0;
+	int ret = 0;
+	k_spinlock_key_t key;
+
+	if (!smb_configured) {
+		ret = i2c_hub_config(CONFIG_SMCHOST_SMBUS_HC_I2C_PORT);
+		smb_configured = !ret;
+	}
+
+	if (!ret) {
+		ret = smb_execute(&req, &bcnt, data);
+	}
+
+	if (ret) {
+		LOG_WRN("SMB prtcl %x addr %x failed %d", req.prtcl, req.addr,
+			ret);
+	}
+
+	key = k_spin_lock(&smb_lock);
+	/* Host reused the registers for a new request, the result of the
+	 * previous one can't be reported anymore so only the new one is.
+	 */
+	if (smb_next_pending) {
+		req = next_req;
+		smb_next_pending = false;
+		k_spin_unlock(&smb_lock, key);
+		LOG_WRN("SMB prtcl %x superseded", req.prtcl);
+		k_work_submit(work);
+		return;
+	}
+
+	if (!ret && bcnt) {
+		memcpy(smb->data, data, bcnt);
+		smb->bcnt = bcnt;
+	}
+
+	/* Completion is signaled by clearing the protocol register */
+	smb->sts = SMB_STS_DONE | smb_status(ret);
+	smb->prtcl = SMB_PRTCL_NONE;
+	smb_busy = false;
+	k_spin_unlock(&smb_lock, key);
+
+	enqueue_sci(SCI_SMB);
+}
+
+static K_WORK_DEFINE(smb_work, smb_work_handler);
+
+/* Host starts a transaction by writing the protocol register last */
+static void smb_prtcl_handler(uint8_t offset)
+{
+	struct acpi_smb_hc *smb = &g_acpi_tbl.acpi_smb;
+	k_spinlock_key_t key;
+
+	if (smb->prtcl == SMB_PRTCL_NONE) {
+		return;
+	}
+
+	key = k_spin_lock(&smb_lock);
+	smb->sts = 0;
+	/* Executed once the ongoing transaction completes */
+	if (smb_busy) {
+		smb_snapshot(&next_req);
+		smb_next_pending = true;
+		k_spin_unlock(&smb_lock, key);
+		LOG_WRN("SMB transaction in progress, prtcl %x queued",
+			next_req.prtcl);
+		return;
+	}
+
+	smb_snapshot(&req);
+	smb_busy = true;
+	k_spin_unlock(&smb_lock, key);
+
+	k_work_submit(&smb_work);
+}
+
+SMC_ACPI_SUBSCRIBE(acpi_sub_smb_prtcl, acpi_smb.prtcl, smb_prtcl_handler);
@@ -14,6 +14,7 @@
 #include "sci.h"
 #include "acpi.h"
 #include "thermalmgmt.h"
+#include "peci_hub.h"
 
 LOG_MODULE_DECLARE(smchost, CONFIG_SMCHOST_LOG_LEVEL);
 
@@ -79,26 +80,28 @@ static void update_hw_peripherals_status(void)
 	send_to_host(hw_peripherals_sts, sizeof(hw_peripherals_sts));
 }
 
-void smchost_cmd_thermal_handler(uint8_t command)
+static void update_pwm_with_bios_override(void)
 {
-	switch (command) {
-	case SMCHOST_SET_OS_ACTIVE_TRIP:
-		set_os_active_trip();
-		break;
-	case SMCHOST_SET_SHDWN_THRESHOLD:
-		set_shutdown_threshold();
-		break;
-	case SMCHOST_UPDATE_PWM:
-		update_pwm();
-		break;
-	case SMCHOST_BIOS_FAN_CONTROL:
-		update_pwm_with_override(host_req[1]);
-		break;
-	case SMCHOST_GET_HW_PERIPHERALS_STS:
-		update_hw_peripherals_status();
-		break;
-	default:
-		LOG_WRN("%s: command 0x%X without handler", __func__, command);
-		break;
-	}
+	update_pwm_with_override(host_req[1]);
 }
+
+static void change_peci_access_mode(void)
+{
+#ifndef CONFIG_DEPRECATED_HW_STRAP_BASED_PECI_MODE_SEL
+	LOG_DBG("%s:Host peci_mode : %x", __func__, host_req[1]);
+	peci_access_mode_config(host_req[1]);
+#endif /* CONFIG_DEPRECATED_HW_STRAP_BASED_PECI_MODE_SEL */
+}
+
+/* Thermal commands drive fans and PECI, which are only powered in S0 */
+SMCHOST_CMD_DEFINE(SMCHOST_SET_OS_ACTIVE_TRIP, 2, SMCHOST_CMD_PWR_S0, 0,
+		   set_os_active_trip);
+SMCHOST_CMD_DEFINE(SMCHOST_SET_SHDWN_THRESHOLD, 1, SMCHOST_CMD_PWR_S0, 0,
+		   set_shutdown_threshold);
+SMCHOST_CMD_DEFINE(SMCHOST_UPDATE_PWM, 0, SMCHOST_CMD_PWR_S0, 0, update_pwm);
+SMCHOST_CMD_DEFINE(SMCHOST_BIOS_FAN_CONTROL, 1, SMCHOST_CMD_PWR_S0, 0,
+		   update_pwm_with_bios_override);
+SMCHOST_CMD_DEFINE(SMCHOST_GET_HW_PERIPHERALS_STS, 0, SMCHOST_CMD_PWR_S0, 0,
+		   update_hw_peripherals_status);
+SMCHOST_CMD_DEFINE(SMCHOST_SET_PECI_ACCESS_MODE, 1, SMCHOST_CMD_PWR_S0, 0,
+		   change_peci_access_mode);
@@ -43,12 +43,13 @@ LOG_MODULE_REGISTER(thermal, CONFIG_THERMAL_MGMT_LOG_LEVEL);
 /* GPU fail critical temperature value is 72C */
 #define GPU_FAIL_CRITICAL_TEMPERATURE		72U
 
-/* To reduce polling frequency of PCH Temperature over OOB channel, read only
- * once out of 10 times.
- */
-#define PCH_TEMP_POLLING_CNT_TIME_DIVISION	10U
 #define PCH_TEMP_BUF_SIZE			6U
 
+BUILD_ASSERT(CONFIG_THERMAL_POLL_FAR_DEG > CONFIG_THERMAL_POLL_NEAR_DEG,
+	     "Sampling can't slow down before the near trip headroom");
+BUILD_ASSERT(CONFIG_THERMAL_POLL_MAX_MS >= CONFIG_THERMAL_POLL_MIN_MS,
+	     "Maximum sampling interval below the minimum");
+
 /*
  * EC Self control fan speed based on CPU temperature info.
  *
@@ -75,6 +76,26 @@ static bool fan_duty_cycle_change;
 static int cpu_temp;
 static uint8_t fan_en_bits;
 
+/* Adaptive sampling of a temperature source */
+struct therm_poll {
+	/* Uptime in ms the source is sampled next */
+	int64_t due;
+	/* Uptime in ms and value of the previous sample, 0 ms if none */
+	int64_t last_ms;
+	int last_temp;
+	/* Uptime in ms the outstanding PECI read was started */
+	int64_t started;
+};
+
+static struct therm_poll sensors_poll;
+static struct therm_poll sensor_polls[ACPI_THRM_SEN_TOTAL];
+static struct therm_poll cpu_poll;
+static struct therm_poll gpu_poll;
+static struct therm_poll pch_poll;
+static uint32_t poll_min_ms = CONFIG_THERMAL_POLL_MIN_MS;
+/* Uptime in ms the thread has to wake up next */
+static int64_t next_wake;
+
 void host_update_crit_temp(uint8_t crit_temp)
 {
 	g_acpi_tbl.acpi_crit_temp = host_req[1] == 0 ?
@@ -214,15 +235,17 @@ void host_update_fan_speed(enum fan_type idx, uint8_t duty_cycle)
 	if (idx == FAN_CPU && bios_fan_override) {
 		fan_duty_cycle[FAN_CPU] = bios_fan_speed;
 		fan_duty_cycle_change = 1;
-		return;
-	}
-	if (idx < max_fan_dev) {
+	} else if (idx < max_fan_dev) {
 		fan_duty_cycle[idx] = duty_cycle;
 		fan_duty_cycle_change = 1;
 		LOG_INF("Updating fan duty cycle to %d", duty_cycle);
 	} else {
 		LOG_WRN("Invalid fan index");
+		return;
 	}
+
+	/* Don't wait for the next temperature sample */
+	wake_task((const char *)THRML_MGMT_TASK_NAME);
 }
 
 /**
@@ -316,21 +339,123 @@ static void manage_fan(void)
 	}
 }
 
-static void manage_thermal_sensors(void)
+static void therm_wake_at(int64_t when)
+{
+	next_wake = MIN(next_wake, when);
+}
+
+/* Closest trip point at or above the temperature. Host passive and active
+ * trip points and the BSOD override are below the critical one if set.
+ */
+static int therm_trip_above(int temp)
+{
+	int trip = g_acpi_tbl.acpi_crit_temp;
+	int trips[] = {
+		g_acpi_tbl.acpi_passive_temp,
+		g_acpi_tbl.acpi_active_temp,
+		therm_bsod_override_acpi.is_bsod_setting_en ?
+			therm_bsod_override_acpi.temp_bsod_override : 0,
+	};
+
+	for (int i = 0; i < ARRAY_SIZE(trips); i++) {
+		if (trips[i] && trips[i] >= temp && trips[i] < trip) {
+			trip = trips[i];
+		}
+	}
+
+	return trip;
+}
+
+/* Sampling interval stretches from the minimum, close to a trip point, to
+ * the maximum far from it. A rising temperature is sampled at least twice
+ * before it gets close to the trip point.
+ */
+static uint32_t therm_poll_interval(struct therm_poll *p, int temp,
+				    int64_t now)
+{
+	int headroom = therm_trip_above(temp) - temp;
+	int rise = temp - p->last_temp;
+	uint32_t interval;
+
+	if (headroom <= CONFIG_THERMAL_POLL_NEAR_DEG) {
+		interval = poll_min_ms;
+	} else if (headroom >= CONFIG_THERMAL_POLL_FAR_DEG) {
+		interval = CONFIG_THERMAL_POLL_MAX_MS;
+	} else {
+		interval = poll_min_ms +
+			   (CONFIG_THERMAL_POLL_MAX_MS - poll_min_ms) *
+			   (headroom - CONFIG_THERMAL_POLL_NEAR_DEG) /
+			   (CONFIG_THERMAL_POLL_FAR_DEG -
+			    CONFIG_THERMAL_POLL_NEAR_DEG);
+	}
+
+	if (p->last_ms && rise > 0 &&
+	    headroom > CONFIG_THERMAL_POLL_NEAR_DEG) {
+		int64_t near_ms = (now - p->last_ms) *
+				  (headroom - CONFIG_THERMAL_POLL_NEAR_DEG) /
+				  rise;
+
+		interval = MIN(interval, near_ms / 2);
+	}
+
+	p->last_ms = now;
+	p->last_temp = temp;
+
+	return MAX(interval, poll_min_ms);
+}
+
+static void therm_poll_schedule(struct therm_poll *p, int64_t now,
+				uint32_t interval)
+{
+	p->due = now + interval;
+	therm_wake_at(p->due);
+}
+
+static bool therm_poll_due(struct therm_poll *p, int64_t now)
+{
+	if (p->due > now) {
+		therm_wake_at(p->due);
+		return false;
+	}
+
+	return true;
+}
+
+/* Source is not monitored, it is sampled right away once it is again */
+static void therm_poll_reset(struct therm_poll *p)
+{
+	p->due = 0;
+	p->last_ms = 0;
+}
+
+static void manage_thermal_sensors(int64_t now)
 {
+	uint32_t interval = CONFIG_THERMAL_POLL_MAX_MS;
+
 	/* Do not attempt to update if no sensors were detected */
 	if (!thermal_initialized) {
 		return;
 	}
 
+	/* Sensors are read together, as often as the hottest one needs */
+	if (!therm_poll_due(&sensors_poll, now)) {
+		return;
+	}
+
 	adc_sensors_read_all();
 
 	for (uint8_t idx = 0; idx < ACPI_THRM_SEN_TOTAL; idx++) {
 		if (therm_sensors[idx] < ADC_CH_TOTAL) {
-			smc_update_thermal_sensor(idx, adc_temp_val[therm_sensors[idx]]);
+			int temp = adc_temp_val[therm_sensors[idx]];
+
+			smc_update_thermal_sensor(idx, temp);
+			interval = MIN(interval,
+				       therm_poll_interval(&sensor_polls[idx],
+							   temp, now));
 		}
 	}
 
+	therm_poll_schedule(&sensors_poll, now, interval);
 }
 
 K_TIMER_DEFINE(peci_delay_timer, NULL, NULL);
@@ -340,8 +465,12 @@ void peci_start_delay_timer(void)
 	/* start a one-shot timer for prescribed seconds */
 	k_timer_start(&peci_delay_timer, K_SECONDS(CPU_TEMP_ACCESS_DELAY_SEC),
 		      K_NO_WAIT);
+	/* Values read before platform reset may no longer hold */
+	peci_cache_invalidate();
 	smc_update_cpu_temperature(CPU_FAIL_SAFE_TEMPERATURE);
 	LOG_DBG("PECI delay timer started");
+	/* Fan is powered on without waiting for the next sample */
+	wake_task((const char *)THRML_MGMT_TASK_NAME);
 }
 
 void host_set_bios_bsod_override(uint8_t temp_bsod_override_val,
@@ -352,49 +481,128 @@ void host_set_bios_bsod_override(uint8_t temp_bsod_override_val,
 	therm_bsod_override_acpi.fan_bsod_override = fan_bsod_override_val;
 }
 
-static void manage_cpu_thermal(void)
+/* Failed reads are retried without waiting for the temperature to settle.
+ * Interval counts from the read start so collecting the result a tick
+ * later doesn't stretch the sampling period, the wake up is set once the
+ * next read is started.
+ */
+static void sample_peci_temp(struct therm_poll *p, int ret, int temp,
+			     int64_t now)
+{
+	if (ret) {
+		p->due = p->started + poll_min_ms;
+	} else {
+		p->due = p->started + therm_poll_interval(p, temp, now);
+	}
+}
+
+/* Collects the temperature read started when the device was due and
+ * starts the next one in the same tick once due again, so a slow PECI over
+ * eSPI doesn't delay fan control. Returns -EINPROGRESS when no new
+ * temperature is available.
+ */
+static int poll_peci_temp(enum peci_devices dev, struct therm_poll *p,
+			  int64_t now, int *temp)
+{
+	int ret = peci_get_temp_result(dev, temp);
+	bool busy = ret == -EINPROGRESS;
+
+	switch (ret) {
+	case -EAGAIN:
+		/* TjMax was read, temperature is read right away */
+		p->due = now;
+		ret = -EINPROGRESS;
+		break;
+	case -ENODATA:
+		ret = -EINPROGRESS;
+		break;
+	case -EINPROGRESS:
+		break;
+	default:
+		sample_peci_temp(p, ret, *temp, now);
+		break;
+	}
+
+	/* Nothing is started while previous read is outstanding */
+	if (busy || (therm_poll_due(p, now) && !peci_get_temp_async(dev))) {
+		if (!busy) {
+			p->started = now;
+		}
+
+		/* Result is collected on next wake */
+		therm_wake_at(now + poll_min_ms);
+	}
+
+	return ret;
+}
+
+/* Temperatures read while the device was not monitored are stale, even
+ * the ones completing later.
+ */
+static void drop_peci_temp(enum peci_devices dev)
+{
+	peci_get_temp_cancel(dev);
+}
+
+static void manage_cpu_thermal(int64_t now)
 {
 	int temp, ret, temp_change;
 	static int prev_notify_temp;
+	uint32_t delay_ms = k_timer_remaining_get(&peci_delay_timer);
 
 	/* Manage CPU thermal only in S0 state */
-	if (!peci_initialized || k_timer_remaining_get(&peci_delay_timer) ||
+	if (!peci_initialized || delay_ms ||
 	    (pwrseq_system_state() != SYSTEM_S0_STATE)) {
+		drop_peci_temp(CPU);
+		drop_peci_temp(GPU);
+		therm_poll_reset(&cpu_poll);
+		therm_poll_reset(&gpu_poll);
+		if (delay_ms) {
+			therm_wake_at(now + delay_ms);
+		}
 		return;
 	}
 
 	/* Read CPU temperature using peci */
-	ret = peci_get_temp(CPU, &temp);
-	if (ret) {
-		LOG_ERR("Failed to get cpu temperature, ret-%x", ret);
-		temp = CPU_FAIL_CRITICAL_TEMPERATURE;
-	}
+	ret = poll_peci_temp(CPU, &cpu_poll, now, &temp);
+	if (ret != -EINPROGRESS) {
+		if (ret) {
+			LOG_ERR("Failed to get cpu temperature, ret-%x", ret);
+			temp = CPU_FAIL_CRITICAL_TEMPERATURE;
+		}
 
-	cpu_temp = temp;
+		cpu_temp = temp;
 
-	/* Update the CPU temperature to acpi offset */
-	smc_update_cpu_temperature(temp);
-	LOG_INF("%s: Cpu Temp=%d", __func__, temp);
+		/* Update the CPU temperature to acpi offset */
+		smc_update_cpu_temperature(temp);
+		LOG_INF("%s: Cpu Temp=%d", __func__, temp);
 
-	/* Trigger shutdown if temp crosses above critical threshold */
-	if (cpu_temp >= g_acpi_tbl.acpi_crit_temp) {
-		LOG_DBG("EC thermal shutdown");
-		therm_shutdown();
-		return;
+		/* Trigger shutdown if temp crosses above critical threshold */
+		if (cpu_temp >= g_acpi_tbl.acpi_crit_temp) {
+			LOG_DBG("EC thermal shutdown");
+			therm_shutdown();
+			return;
+		}
 	}
 
 	/* Read GPU temperature using peci if the GPU is in an active state */
 	if ((gpio_read_pin(DG2_PRESENT) == HIGH) &&
 	    (gpio_read_pin(PEG_RTD3_COLD_MOD_SW_R) == HIGH)) {
-		ret = peci_get_temp(GPU, &temp);
-		if (ret) {
-			LOG_ERR("Failed to get GPU temperature, ret-%x", ret);
-			temp = GPU_FAIL_CRITICAL_TEMPERATURE;
+		ret = poll_peci_temp(GPU, &gpu_poll, now, &temp);
+		if (ret != -EINPROGRESS) {
+			if (ret) {
+				LOG_ERR("Failed to get GPU temperature, ret-%x",
+					ret);
+				temp = GPU_FAIL_CRITICAL_TEMPERATURE;
+			}
+
+			/* Update the GPU temperature to acpi offset */
+			smc_update_gpu_temperature(temp);
+			LOG_WRN("%s: GPU Temp=%d", __func__, temp);
 		}
-
-		/* Update the GPU temperature to acpi offset */
-		smc_update_gpu_temperature(temp);
-		LOG_WRN("%s: GPU Temp=%d", __func__, temp);
+	} else {
+		drop_peci_temp(GPU);
+		therm_poll_reset(&gpu_poll);
 	}
 
 	/* Check temperature change and alert OS */
@@ -410,11 +618,10 @@ static void manage_cpu_thermal(void)
 	}
 }
 
-static void manage_pch_temperature(void)
+static void manage_pch_temperature(int64_t now)
 {
-	static uint8_t temp_poll_cnt = PCH_TEMP_POLLING_CNT_TIME_DIVISION;
-
 	if (pwrseq_system_state() != SYSTEM_S0_STATE) {
+		therm_poll_reset(&pch_poll);
 		return;
 	}
 
@@ -422,13 +629,11 @@ static void manage_pch_temperature(void)
 	if (smchost_is_system_in_cs()) {
 		return;
 	}
-	/* To slow down polling on PCH Temperature, read only once per/sec. */
-	if (temp_poll_cnt--) {
+
+	if (!therm_poll_due(&pch_poll, now)) {
 		return;
 	}
 
-	temp_poll_cnt = PCH_TEMP_POLLING_CNT_TIME_DIVISION;
-
 	uint8_t pchtemp[PCH_TEMP_BUF_SIZE] = {
 		OOB_DST_ADDR(OOB_MASTER_ADDR_HW),
 		OOB_CMD_CODE_HW_TEMP,
@@ -444,6 +649,11 @@ static void manage_pch_temperature(void)
 
 		LOG_DBG("PCH Temp = %d", msg->payload[0]);
 		smc_update_pch_dts_temperature(msg->payload[0]);
+		therm_poll_schedule(&pch_poll, now,
+				    therm_poll_interval(&pch_poll,
+							msg->payload[0], now));
+	} else {
+		therm_poll_schedule(&pch_poll, now, poll_min_ms);
 	}
 }
 
@@ -462,6 +672,7 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 {
 	uint32_t normal_period = *(uint32_t *)p1;
 	g_acpi_tbl.acpi_crit_temp = THERM_SHTDWN_THRSD;
+	int64_t now;
 	int err;
 
 	init_fans();
@@ -471,6 +682,10 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 		peci_initialized = true;
 	}
 
+	/* Sampling interval never goes below the thread period */
+	poll_min_ms = normal_period;
+	next_wake = k_uptime_get();
+
 	while (true) {
 		/* Each thread is aware of CS
 		 * Thread uses different sleep time during CS
@@ -479,9 +694,12 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 		if (smchost_is_system_in_cs()) {
 			k_sleep(K_SECONDS(CPU_TEMP_CS_ACCESS_PERIOD_SEC));
 		} else {
-			k_msleep(normal_period);
+			/* Sleep until the next source is due */
+			k_msleep((int32_t)MAX(next_wake - k_uptime_get(), 0));
 		}
 
+		now = k_uptime_get();
+		next_wake = now + CONFIG_THERMAL_POLL_MAX_MS;
 		manage_fan();
 
 		/* To achieve infinite C10 residency in connected standby
@@ -493,9 +711,9 @@ void thermalmgmt_thread(void *p1, void *p2, void *p3)
 			continue;
 		}
 #endif
-		manage_thermal_sensors();
-		manage_cpu_thermal();
-		manage_pch_temperature();
+		manage_thermal_sensors(now);
+		manage_cpu_thermal(now);
+		manage_pch_temperature(now);
 	}
 }
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "acpi.h"
+#include "acpi_emul.h"
+#include "espi_hub.h"
+
+LOG_MODULE_REGISTER(acpi_emul, CONFIG_ACPI_EMUL_LOG_LEVEL);
+
+#define ACPI_EMUL_INTERFACES	2u
+#define ACPI_EMUL_STACK_SIZE	1024
+
+/* Emulated IBF/OBE interrupt preempts all EC tasks */
+#define ACPI_EMUL_IRQ_PRIORITY	K_PRIO_COOP(0)
+
+struct acpi_emul_regs {
+	uint8_t sts;
+	uint8_t idr;
+	uint8_t odr;
+};
+
+static struct acpi_emul_regs regs[ACPI_EMUL_INTERFACES];
+static struct k_spinlock emul_lock;
+static K_SEM_DEFINE(host_irq, 0, 1);
+
+bool acpi_get_flag(enum acpi_ec_interface num, uint8_t type)
+{
+	return regs[num].sts & type;
+}
+
+void acpi_set_flag(enum acpi_ec_interface num, uint8_t type, bool val)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	if (val) {
+		regs[num].sts |= type;
+	} else {
+		regs[num].sts &= ~type;
+	}
+
+	k_spin_unlock(&emul_lock, key);
+}
+
+uint8_t acpi_read_idr(enum acpi_ec_interface num)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+	uint8_t data = regs[num].idr;
+
+	regs[num].sts &= ~ACPI_FLAG_IBF;
+	k_spin_unlock(&emul_lock, key);
+
+	return data;
+}
+
+void acpi_write_odr(enum acpi_ec_interface num, uint8_t byte)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	regs[num].odr = byte;
+	regs[num].sts |= ACPI_FLAG_OBF;
+	k_spin_unlock(&emul_lock, key);
+}
+
+uint8_t acpi_read_str(enum acpi_ec_interface num)
+{
+	return regs[num].sts;
+}
+
+int acpi_send_byte(enum acpi_ec_interface num, uint8_t data)
+{
+	for (uint16_t i = 0; i < HOST_TIMEOUT; i++) {
+
+		if (acpi_get_flag(num, ACPI_FLAG_OBF) == 1) {
+			continue;
+		}
+
+		acpi_write_odr(num, data);
+		return 0;
+	}
+	return -1;
+}
+
+static int host_write(enum acpi_ec_interface num, uint8_t byte, bool cmd)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	if (regs[num].sts & ACPI_FLAG_IBF) {
+		k_spin_unlock(&emul_lock, key);
+		return -EBUSY;
+	}
+
+	regs[num].idr = byte;
+	regs[num].sts |= ACPI_FLAG_IBF;
+	if (cmd) {
+		regs[num].sts |= ACPI_FLAG_CD;
+	} else {
+		regs[num].sts &= ~ACPI_FLAG_CD;
+	}
+	k_spin_unlock(&emul_lock, key);
+
+	/* Only public interface is routed to EC FW */
+	if (num == ACPI_EC_0) {
+		k_sem_give(&host_irq);
+	}
+
+	return 0;
+}
+
+int acpi_emul_host_write_cmd(enum acpi_ec_interface num, uint8_t cmd)
+{
+	return host_write(num, cmd, true);
+}
+
+int acpi_emul_host_write_data(enum acpi_ec_interface num, uint8_t data)
+{
+	return host_write(num, data, false);
+}
+
+int acpi_emul_host_read_data(enum acpi_ec_interface num, uint8_t *data)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	if (!(regs[num].sts & ACPI_FLAG_OBF)) {
+		k_spin_unlock(&emul_lock, key);
+		return -ENODATA;
+	}
+
+	*data = regs[num].odr;
+	regs[num].sts &= ~ACPI_FLAG_OBF;
+	k_spin_unlock(&emul_lock, key);
+
+	/* Output buffer empty is notified as host I/O event too */
+	if (num == ACPI_EC_0) {
+		k_sem_give(&host_irq);
+	}
+
+	return 0;
+}
+
+uint8_t acpi_emul_host_read_sts(enum acpi_ec_interface num)
+{
+	return regs[num].sts;
+}
+
+/* Delivers interrupts the same way eSPI peripheral channel does */
+static void acpi_emul_irq_thread(void *p1, void *p2, void *p3)
+{
+	while (true) {
+		k_sem_take(&host_irq, K_FOREVER);
+		espihub_acpi_event();
+	}
+}
+
+K_THREAD_DEFINE(acpi_emul_irq_id, ACPI_EMUL_STACK_SIZE, acpi_emul_irq_thread,
+		NULL, NULL, NULL, ACPI_EMUL_IRQ_PRIORITY, 0, 0);
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Host side interface of the ACPI EC emulator.
+ *
+ * The emulator replaces the SoC ACPI EC interface with a register model of
+ * the 0x62 data / 0x66 command-status port pair. Host accesses raise the IBF
+ * or OBE interrupt towards the EC, EC accesses go through the regular acpi.h
+ * APIs.
+ */
+
+#ifndef __ACPI_EMUL_H__
+#define __ACPI_EMUL_H__
+
+#include "acpi.h"
+
+/**
+ * @brief Host write to the EC command port.
+ *
+ * @param num the ACPI EC interface.
+ * @param cmd the command byte.
+ *
+ * @retval -EBUSY if EC has not read the previous byte, 0 otherwise.
+ */
+int acpi_emul_host_write_cmd(enum acpi_ec_interface num, uint8_t cmd);
+
+/**
+ * @brief Host write to the EC data port.
+ *
+ * @param num the ACPI EC interface.
+ * @param data the data byte.
+ *
+ * @retval -EBUSY if EC has not read the previous byte, 0 otherwise.
+ */
+int acpi_emul_host_write_data(enum acpi_ec_interface num, uint8_t data);
+
+/**
+ * @brief Host read from the EC data port.
+ *
+ * @param num the ACPI EC interface.
+ * @param data the byte sent by the EC.
+ *
+ * @retval -ENODATA if output buffer is empty, 0 otherwise.
+ */
+int acpi_emul_host_read_data(enum acpi_ec_interface num, uint8_t *data);
+
+/**
+ * @brief Host read from the EC status port.
+ *
+ * @param num the ACPI EC interface.
+ *
+ * @retval the EC status register.
+ */
+uint8_t acpi_emul_host_read_sts(enum acpi_ec_interface num);
+
+#endif /* __ACPI_EMUL_H__ */
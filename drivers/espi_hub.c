@@ -69,6 +69,24 @@ int espihub_add_acpi_handler(enum espihub_acpi_handler type,
 	return 0;
 }
 
+void espihub_acpi_event(void)
+{
+	if (acpi_handlers[ESPIHUB_ACPI_PUBLIC]) {
+		acpi_handlers[ESPIHUB_ACPI_PUBLIC]();
+	} else {
+		LOG_WRN("No ACPI handler registered");
+	}
+}
+
+void espihub_kbc_event(struct espi_evt_data_kbc *kbc)
+{
+	if (kbc_handler) {
+		kbc_handler(kbc);
+	} else {
+		LOG_WRN("No KBC handler registered");
+	}
+}
+
 int espihub_add_kbc_handler(espi_kbc_handler_t handler)
 {
 	__ASSERT(handler, "Handler shouldn't be NULL");
@@ -284,11 +302,7 @@ static void periph_handler(const struct device *dev, struct espi_callback *cb,
 		}
 		break;
 	case ESPI_PERIPHERAL_HOST_IO:
-		if (acpi_handlers[ESPIHUB_ACPI_PUBLIC]) {
-			acpi_handlers[ESPIHUB_ACPI_PUBLIC]();
-		} else {
-			LOG_WRN("No ACPI handler registered");
-		}
+		espihub_acpi_event();
 		break;
 #ifdef CONFIG_ESPI_PERIPHERAL_8042_KBC
 	case ESPI_PERIPHERAL_8042_KBC:
@@ -296,13 +310,7 @@ static void periph_handler(const struct device *dev, struct espi_callback *cb,
 		 * byte indicates if the information received was command
 		 * or data
 		 */
-		if (kbc_handler) {
-			struct espi_evt_data_kbc *kbc_evt =
-				(struct espi_evt_data_kbc *)&event.evt_data;
-			kbc_handler(kbc_evt);
-		} else {
-			LOG_WRN("No KBC handler registered");
-		}
+		espihub_kbc_event((struct espi_evt_data_kbc *)&event.evt_data);
 		break;
 #endif
 	default:
@@ -568,6 +576,7 @@ int espihub_send_oob(struct espi_oob_packet *req_pckt)
 	return espi_send_oob(espi_dev, req_pckt);
 }
 
+#ifndef CONFIG_KBC_EMUL
 int espihub_kbc_write(enum lpc_peripheral_opcode cmd, uint32_t data)
 {
 	uint32_t ldata = data;
@@ -579,6 +588,7 @@ int espihub_kbc_read(enum lpc_peripheral_opcode cmd, uint32_t *data)
 {
 	return espi_read_lpc_request(espi_dev, cmd, data);
 }
+#endif
 
 #ifdef ENABLE_ESPI_LTR
 int espihub_send_ltr(void)
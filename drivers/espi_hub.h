@@ -202,6 +202,24 @@ int espihub_add_warn_handler(enum espihub_handler handler_type,
 int espihub_add_acpi_handler(enum espihub_acpi_handler type,
 			     espi_acpi_handler_t handler);
 
+/**
+ * @brief Notify ACPI EC host activity to the registered handler.
+ *
+ * Called on host I/O peripheral events, also used by the ACPI EC emulator
+ * to signal an input buffer full interrupt.
+ */
+void espihub_acpi_event(void);
+
+/**
+ * @brief Notify 8042 KBC host activity to the registered handler.
+ *
+ * Called on 8042 peripheral events, also used by the 8042 KBC emulator
+ * to signal input buffer full and output buffer empty interrupts.
+ *
+ * @param kbc the 8042 event.
+ */
+void espihub_kbc_event(struct espi_evt_data_kbc *kbc);
+
 /**
  * @brief Add a keyboard subsystem handler.
  *
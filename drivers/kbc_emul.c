@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include "espi_hub.h"
+#include "kbc_emul.h"
+
+LOG_MODULE_REGISTER(kbc_emul, CONFIG_KBC_EMUL_LOG_LEVEL);
+
+#define KBC_EMUL_STACK_SIZE	1024
+#define KBC_EMUL_EVENTS		4
+
+/* Emulated IBF/OBE interrupt preempts all EC tasks */
+#define KBC_EMUL_IRQ_PRIORITY	K_PRIO_COOP(0)
+
+/* Flags the EC is allowed to change with E8042_SET/CLEAR_FLAG */
+#define KBC_EMUL_EC_FLAGS	KBC_EMUL_STS_SYS
+
+static struct {
+	uint8_t sts;
+	uint8_t idr;
+	uint8_t odr;
+} regs;
+
+static struct k_spinlock emul_lock;
+static atomic_t irq_paused;
+static K_SEM_DEFINE(irq_resume, 0, 1);
+K_MSGQ_DEFINE(kbc_emul_evts, sizeof(struct espi_evt_data_kbc), KBC_EMUL_EVENTS,
+	      4);
+
+static void raise_event(uint8_t evt, uint8_t type, uint8_t data)
+{
+	struct espi_evt_data_kbc kbc_evt = {
+		.type = type,
+		.data = data,
+		.evt = evt,
+	};
+
+	/* OBE events may be coalesced, EC only waits for the first one */
+	if (k_msgq_put(&kbc_emul_evts, &kbc_evt, K_NO_WAIT)) {
+		LOG_DBG("KBC event %d dropped", evt);
+	}
+}
+
+static void write_odr(uint8_t data, bool aux)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	regs.odr = data;
+	regs.sts |= KBC_EMUL_STS_OBF;
+	if (aux) {
+		regs.sts |= KBC_EMUL_STS_AUX_OBF;
+	} else {
+		regs.sts &= ~KBC_EMUL_STS_AUX_OBF;
+	}
+	k_spin_unlock(&emul_lock, key);
+}
+
+static void update_sts(uint8_t set, uint8_t clear)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	regs.sts = (regs.sts & ~clear) | set;
+	k_spin_unlock(&emul_lock, key);
+}
+
+int espihub_kbc_write(enum lpc_peripheral_opcode cmd, uint32_t data)
+{
+	switch (cmd) {
+	case E8042_WRITE_KB_CHAR:
+		write_odr(data, false);
+		break;
+	case E8042_WRITE_MB_CHAR:
+		write_odr(data, true);
+		break;
+	case E8042_CLEAR_OBF:
+		update_sts(0, KBC_EMUL_STS_OBF | KBC_EMUL_STS_AUX_OBF);
+		break;
+	case E8042_SET_FLAG:
+		update_sts(data & KBC_EMUL_EC_FLAGS, 0);
+		break;
+	case E8042_CLEAR_FLAG:
+		update_sts(0, data & KBC_EMUL_EC_FLAGS);
+		break;
+	case E8042_PAUSE_IRQ:
+		atomic_set(&irq_paused, 1);
+		break;
+	case E8042_RESUME_IRQ:
+		atomic_clear(&irq_paused);
+		k_sem_give(&irq_resume);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+int espihub_kbc_read(enum lpc_peripheral_opcode cmd, uint32_t *data)
+{
+	switch (cmd) {
+	case E8042_OBF_HAS_CHAR:
+		*data = !!(regs.sts & KBC_EMUL_STS_OBF);
+		break;
+	case E8042_IBF_HAS_CHAR:
+		*data = !!(regs.sts & KBC_EMUL_STS_IBF);
+		break;
+	case E8042_READ_KB_STS:
+		*data = regs.sts;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int host_write(uint8_t byte, bool cmd)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	if (regs.sts & KBC_EMUL_STS_IBF) {
+		k_spin_unlock(&emul_lock, key);
+		return -EBUSY;
+	}
+
+	regs.idr = byte;
+	regs.sts |= KBC_EMUL_STS_IBF;
+	if (cmd) {
+		regs.sts |= KBC_EMUL_STS_CD;
+	} else {
+		regs.sts &= ~KBC_EMUL_STS_CD;
+	}
+	k_spin_unlock(&emul_lock, key);
+
+	raise_event(HOST_KBC_EVT_IBF, cmd, byte);
+
+	return 0;
+}
+
+int kbc_emul_host_write_cmd(uint8_t cmd)
+{
+	return host_write(cmd, true);
+}
+
+int kbc_emul_host_write_data(uint8_t data)
+{
+	return host_write(data, false);
+}
+
+int kbc_emul_host_read_data(uint8_t *data)
+{
+	k_spinlock_key_t key = k_spin_lock(&emul_lock);
+
+	if (!(regs.sts & KBC_EMUL_STS_OBF)) {
+		k_spin_unlock(&emul_lock, key);
+		return -ENODATA;
+	}
+
+	*data = regs.odr;
+	regs.sts &= ~(KBC_EMUL_STS_OBF | KBC_EMUL_STS_AUX_OBF);
+	k_spin_unlock(&emul_lock, key);
+
+	raise_event(HOST_KBC_EVT_OBE, 0, 0);
+
+	return 0;
+}
+
+uint8_t kbc_emul_host_read_sts(void)
+{
+	return regs.sts;
+}
+
+/* Delivers interrupts the same way eSPI peripheral channel does, the input
+ * buffer is read by the eSPI driver before the event is reported.
+ */
+static void kbc_emul_irq_thread(void *p1, void *p2, void *p3)
+{
+	struct espi_evt_data_kbc kbc_evt;
+
+	while (true) {
+		k_msgq_get(&kbc_emul_evts, &kbc_evt, K_FOREVER);
+
+		while (atomic_get(&irq_paused)) {
+			k_sem_take(&irq_resume, K_FOREVER);
+		}
+
+		if (kbc_evt.evt == HOST_KBC_EVT_IBF) {
+			update_sts(0, KBC_EMUL_STS_IBF);
+		}
+
+		espihub_kbc_event(&kbc_evt);
+	}
+}
+
+K_THREAD_DEFINE(kbc_emul_irq_id, KBC_EMUL_STACK_SIZE, kbc_emul_irq_thread,
+		NULL, NULL, NULL, KBC_EMUL_IRQ_PRIORITY, 0, 0);
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Host side interface of the 8042 KBC emulator.
+ *
+ * The emulator replaces the eSPI 8042 peripheral with a register model of
+ * the 0x60 data / 0x64 command-status port pair. Host accesses raise the IBF
+ * or OBE event towards the EC, EC accesses go through the regular
+ * espihub_kbc_read/write APIs.
+ */
+
+#ifndef __KBC_EMUL_H__
+#define __KBC_EMUL_H__
+
+#include <stdint.h>
+#include <zephyr/sys/util.h>
+
+/* Status register bits as seen by the host on port 0x64 */
+#define KBC_EMUL_STS_OBF	BIT(0)
+#define KBC_EMUL_STS_IBF	BIT(1)
+#define KBC_EMUL_STS_SYS	BIT(2)
+#define KBC_EMUL_STS_CD		BIT(3)
+#define KBC_EMUL_STS_AUX_OBF	BIT(5)
+
+/**
+ * @brief Host write to the 8042 command port 0x64.
+ *
+ * @param cmd the command byte.
+ *
+ * @retval -EBUSY if EC has not read the previous byte, 0 otherwise.
+ */
+int kbc_emul_host_write_cmd(uint8_t cmd);
+
+/**
+ * @brief Host write to the 8042 data port 0x60.
+ *
+ * @param data the data byte.
+ *
+ * @retval -EBUSY if EC has not read the previous byte, 0 otherwise.
+ */
+int kbc_emul_host_write_data(uint8_t data);
+
+/**
+ * @brief Host read from the 8042 data port 0x60.
+ *
+ * @param data the byte sent by the EC.
+ *
+ * @retval -ENODATA if output buffer is empty, 0 otherwise.
+ */
+int kbc_emul_host_read_data(uint8_t *data);
+
+/**
+ * @brief Host read from the 8042 status port 0x64.
+ *
+ * @retval the 8042 status register.
+ */
+uint8_t kbc_emul_host_read_sts(void);
+
+#endif /* __KBC_EMUL_H__ */
@@ -18,8 +18,13 @@ enum kbs_keyseq_type {
 };
 
 struct kbs_keyseq {
+	/* Key pressed last, 0 for sequences made of modifiers only */
 	uint8_t trigger_key;
 	uint8_t modifiers;
+	/* Additional keys held with the trigger, unused entries are 0 */
+	uint8_t chord[CONFIG_KBS_KEYSEQ_CHORD_KEYS];
+	/* Time the whole sequence must be held before notification */
+	uint16_t hold_ms;
 	kbs_key_seq_detected handler;
 	bool detected;
 };
@@ -134,7 +134,7 @@ struct fn_data {
 	enum fn_data_type type;
 	union {
 		/**
-		 * This are expected to be in scan code set 2.
+		 * Already translated for the scan code set requested.
 		 */
 		struct scan_code sc;
 		/** sci data to be enqueued as an sci event. */
@@ -163,6 +163,8 @@ typedef int (*km_get_keynum_t)(uint8_t col, uint8_t row);
  * their side. This is why we return 2 different data types.
  *
  * @param key_num Hint to determine FN+FX key combination.
+ * @param set Scan code set selected by the host, SCAN_CODE_SET1 or
+ * SCAN_CODE_SET2.
  * @param fn_data Represet out data to be generated.
  *
  * Note: This ca be a scancode or an sci depending on what action is
@@ -171,8 +173,8 @@ typedef int (*km_get_keynum_t)(uint8_t col, uint8_t row);
  * @param pressed help to determine a make or brake.
  *
  */
-typedef int (*km_get_fnkey_t)(uint8_t key_num, struct fn_data *data,
-			      bool pressed);
+typedef int (*km_get_fnkey_t)(uint8_t key_num, uint8_t set,
+			      struct fn_data *data, bool pressed);
 
 struct km_api {
 	km_get_keynum_t get_keynum;
@@ -180,18 +182,12 @@ struct km_api {
 };
 
 /**
- * @brief Concrete implementatoin for gtech keyboard init.
+ * @brief Keymap generated from the description selected by
+ * CONFIG_KBS_KEYMAP.
  *
  * @retval Forward a keyboard API to the caller.
  */
-struct km_api *gtech_init();
-
-/**
- * @brief Concrete implementatoin for fujits keyboard init.
- *
- * @retval Forward a keyboard API to the caller.
- */
-struct km_api *fujitsu_init();
+struct km_api *kbs_keymap_init(void);
 
 /**
  * @brief Factory function to select a specific keyboard.
@@ -201,10 +197,8 @@ struct km_api *fujitsu_init();
  */
 inline struct km_api *keymap_init_interface(void)
 {
-#if defined(CONFIG_EC_GTECH_KEYBOARD)
-	return gtech_init();
-#elif defined(CONFIG_EC_FUJITSU_KEYBOARD)
-	return fujitsu_init();
+#ifdef CONFIG_KBS_KEYMAP
+	return kbs_keymap_init();
 #else
 	return NULL;
 #endif
@@ -220,7 +214,7 @@ inline int keymap_get_keynum(struct km_api *api, uint8_t col, uint8_t row)
 }
 
 static inline int keymap_get_fnkey(struct km_api *api, uint8_t key_num,
-			    struct fn_data *data,
+			    uint8_t set, struct fn_data *data,
 			    bool pressed)
 {
 	if (api == NULL) {
@@ -231,7 +225,7 @@ static inline int keymap_get_fnkey(struct km_api *api, uint8_t key_num,
 		return -EINVAL;
 	}
 
-	return api->get_fnkey(key_num, data, pressed);
+	return api->get_fnkey(key_num, set, data, pressed);
 
 }
 
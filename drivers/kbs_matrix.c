@@ -4,13 +4,17 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/kscan.h>
 #include "kbs_keymap.h"
 #include "kbs_matrix.h"
+#include "kbs_matrix_ghost.h"
 #include "board_config.h"
 #include "keyboard_utility.h"
+#include "kbs_scancode_tbl.h"
+#include "kbchost_latency.h"
 #include "sci.h"
 #include "scicodes.h"
 #include "smc.h"
@@ -18,12 +22,12 @@
 #include "kbs_boot_keyseq.h"
 #endif
 #include <zephyr/logging/log.h>
-#include <memops.h>
 LOG_MODULE_DECLARE(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
 
 static const struct device *kscan_dev;
 static struct k_timer typematic_timer;
 static kbs_matrix_callback kbs_callback;
+static kbs_matrix_busy_callback kbs_busy;
 static void typematic_callback(struct k_timer *timer);
 static void kscan_callback(const struct device *dev, uint32_t row,
 			   uint32_t col, bool pressed);
@@ -83,162 +87,65 @@ static const uint16_t typematic_period[] = {
 
 static const uint16_t typematic_delay[] = { 250U, 500U, 750U, 1000U };
 
-#define MAX_SC2_TABLE_SIZE 130U
-/* This table represents the scancode set 2.
- * The flags help to identify whether a key can be sent
- * during a make, break and typemaic scenario
- * NOTE: Do not use this table for ROW 124 (Print Screen) and 126 Pause/Break
- *
- */
-const struct scan_code scan_code2[MAX_SC2_TABLE_SIZE] = {
-/*	Scan code		Len	IBM key map */
-	{{0x00U},		0U},	/* Padding key num */
-	{{0x0EU},		1U},	/* 1  */
-	{{0x16U},		1U},	/* 2  */
-	{{0x1EU},		1U},	/* 3  */
-	{{0x26U},		1U},	/* 4  */
-	{{0x25U},		1U},	/* 5  */
-	{{0x2EU},		1U},	/* 6  */
-	{{0x36U},		1U},	/* 7  */
-	{{0x3DU},		1U},	/* 8  */
-	{{0x3EU},		1U},	/* 9  */
-	{{0x46U},		1U},	/* 10 */
-	{{0x45U},		1U},	/* 11 */
-	{{0x4EU},		1U},	/* 12 */
-	{{0x55U},		1U},	/* 13 */
-	{{0x0U},		1U},	/* 14 */
-	{{0x66U},		1U},	/* 15 */
-	{{0x0DU},		1U},	/* 16 */
-	{{0x15U},		1U},	/* 17 */
-	{{0x1DU},		1U},	/* 18 */
-	{{0x24U},		1U},	/* 19 */
-	{{0x2DU},		1U},	/* 20 */
-	{{0x2CU},		1U},	/* 21 */
-	{{0x35U},		1U},	/* 22 */
-	{{0x3CU},		1U},	/* 23 */
-	{{0x43U},		1U},	/* 24 */
-	{{0x44U},		1U},	/* 25 */
-	{{0x4DU},		1U},	/* 26 */
-	{{0x54U},		1U},	/* 27 */
-	{{0x5BU},		1U},	/* 28 */
-	{{0x5DU},		1U},	/* 29 */
-	{{0x58U},		1U},	/* 30 */
-	{{0x1CU},		1U},	/* 31 */
-	{{0x1BU},		1U},	/* 32 */
-	{{0x23U},		1U},	/* 33 */
-	{{0x2BU},		1U},	/* 34 */
-	{{0x34U},		1U},	/* 35 */
-	{{0x33U},		1U},	/* 36 */
-	{{0x3BU},		1U},	/* 37 */
-	{{0x42U},		1U},	/* 38 */
-	{{0x4BU},		1U},	/* 39 */
-	{{0x4CU},		1U},	/* 40 */
-	{{0x52U},		1U},	/* 41 */
-	{{0x5DU},		1U},	/* 42 */
-	{{0x5AU},		1U},	/* 43 */
-	{{0x12U},		1U},	/* 44 */
-	{{0x61U},		1U},	/* 45 */
-	{{0x1AU},		1U},	/* 46 */
-	{{0x22U},		1U},	/* 47 */
-	{{0x21U},		1U},	/* 48 */
-	{{0x2AU},		1U},	/* 49 */
-	{{0x32U},		1U},	/* 50 */
-	{{0x31U},		1U},	/* 51 */
-	{{0x3AU},		1U},	/* 52 */
-	{{0x41U},		1U},	/* 53 */
-	{{0x49U},		1U},	/* 54 */
-	{{0x4AU},		1U},	/* 55 */
-	{{0U},			0U},	/* 56 */
-	{{0x59U},		1U},	/* 57 */
-	{{0x14U},		1U},	/* 58 */
-	{{0x0U},		0U},	/* 59 */
-	{{0x11U},		1U},	/* 60 */
-	{{0x29U},		1U},	/* 61 */
-	{{0xE0U, 0x11U},	2U},	/* 62 */
-	{{0U},			0U},	/* 63 */
-	{{0xE0U, 0x14U},	2U},	/* 64 */
-	{{0U},			0U},	/* 65 */
-	{{0U},			0U},	/* 66 */
-	{{0U},			0U},	/* 67 */
-	{{0U},			0U},	/* 68 */
-	{{0U},			0U},	/* 69 */
-	{{0U},			0U},	/* 70 */
-	{{0U},			0U},	/* 71 */
-	{{0U},			0U},	/* 72 */
-	{{0U},			0U},	/* 73 */
-	{{0U},			0U},	/* 74 */
-	{{0xE0U, 0x70U},	2U},	/* 75 */
-	{{0xE0U, 0x71U},	2U},	/* 76 */
-	{{0U},			0U},	/* 77 */
-	{{0U},			0U},	/* 78 */
-	{{0xE0U, 0x6BU},	2U},	/* 79 */
-	{{0xE0U, 0x6CU},	2U},	/* 80 */
-	{{0xE0U, 0x69U},	2U},	/* 81 */
-	{{0U},			0U},	/* 82 */
-	{{0xE0U, 0x75U},	2U},	/* 83 */
-	{{0xE0U, 0x72U},	2U},	/* 84 */
-	{{0xE0U, 0x7DU},	2U},	/* 85 */
-	{{0xE0U, 0x7AU},	2U},	/* 86 */
-	{{0U},			0U},	/* 87 */
-	{{0U},			0U},	/* 88 */
-	{{0xE0U, 0x74U},	2U},	/* 89 */
-	{{0x77U},		1U},	/* 90 */
-	{{0x6CU},		1U},	/* 91 */
-	{{0x6BU},		1U},	/* 92 */
-	{{0x69U},		1U},	/* 93 */
-	{{0U},			0U},	/* 94 */
-	{{0xE0U, 0x4AU},	2U},	/* 95 */
-	{{0x75U},		1U},	/* 96 */
-	{{0x73U},		1U},	/* 97 */
-	{{0x72U},		1U},	/* 98 */
-	{{0x70U},		1U},	/* 99 */
-	{{0x7CU},		1U},	/* 100*/
-	{{0x7DU},		1U},	/* 101*/
-	{{0x74U},		1U},	/* 102*/
-	{{0x7AU},		1U},	/* 103*/
-	{{0x71U},		1U},	/* 104*/
-	{{0x7BU},		1U},	/* 105*/
-	{{0x79U},		1U},	/* 106*/
-	{{0U},			0U},	/* 107*/
-	{{0xE0U, 0x5AU},	2U},	/* 108*/
-	{{0U},			0U},	/* 109*/
-	{{0x76U},		1U},	/* 110*/
-	{{0U},			0U},	/* 111*/
-	{{0x05U},		1U},	/* 112*/
-	{{0x06U},		1U},	/* 113*/
-	{{0x04U},		1U},	/* 114*/
-	{{0x0CU},		1U},	/* 115*/
-	{{0x03U},		1U},	/* 116*/
-	{{0x0BU},		1U},	/* 117*/
-	{{0x83U},		1U},	/* 118*/
-	{{0x0AU},		1U},	/* 119*/
-	{{0x01U},		1U},	/* 120*/
-	{{0x09U},		1U},	/* 121*/
-	{{0x78U},		1U},	/* 122*/
-	{{0x07U},		1U},	/* 123*/
-	/* Print screen pressed.
-	 * Note: This entry is marked as unavailable on purpose
-	 * Make : 0xE0, 0x12, 0xE0, 0x7C
-	 * Break sequence 0xE0, 0xF0, 0x7C, 0xE0, 0xF0, 0x12.
-	 * Use the complex can code table defined below for print screen
-	 * function below
-	 */
-	{{0U},			0U},    /* 124*/
-	{{0x7E},		1U},	/* 125*/
-	/* Pause/Break  pressed
-	 * Note: This entry is marked as unavailable on purpose
-	 * Use the the function get pause/break.
-	 */
-	{{0U},			0U},	/* 126*/
-	{{0xE0, 0x1F},		2U},	/* 127*/
-	{{0x29},		1U},	/* 128*/
-	{{0xE0, 0x2F},		2U},	/* 129*/
-};
-
 #ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
-static struct kbs_keyseq keyseq_det[KEYSEQ_MAX_SEQ_COUNT];
+/* Predefined key sequences followed by the runtime ones */
+#define KEYSEQ_COUNT	(KEYSEQ_MAX_SEQ_COUNT + CONFIG_KBS_KEYSEQ_RUNTIME_MAX)
+#define KEYSEQ_KEYS	(UINT8_MAX + 1)
+
+static struct kbs_keyseq keyseq_det[KEYSEQ_COUNT];
+/* Key sequences are chained per trigger key so a key event only walks the
+ * sequences triggered by that key. Links hold the id + 1, 0 ends a chain.
+ */
+static uint8_t keyseq_head[KEYSEQ_KEYS];
+static uint8_t keyseq_next[KEYSEQ_COUNT];
+/* Handler notified of the press, waiting for the release */
+static bool keyseq_active[KEYSEQ_COUNT];
+static ATOMIC_DEFINE(keyseq_held_keys, KEYSEQ_KEYS);
+/* Sequence held, waiting for its hold time to elapse */
+static bool keyseq_pending[KEYSEQ_COUNT];
+static struct k_work_delayable keyseq_hold_work[KEYSEQ_COUNT];
+/* Sequences either active or pending, releases walk all of them */
+static uint8_t keyseq_armed;
+/* Last non-modifier key pressed and still held */
+static uint8_t keyseq_last_key;
+static K_MUTEX_DEFINE(keyseq_mutex);
+
+static void keyseq_link(uint8_t id);
+static void keyseq_release(void);
+static void keyseq_hold_expired(struct k_work *work);
+
+BUILD_ASSERT(KEYSEQ_COUNT < UINT8_MAX, "Too many key sequences");
 #endif
 
+/* Keys held in the matrix, keys pressed since the last scan was evaluated
+ * and keys reported to the host, one column bitmap per row.
+ */
+static uint32_t mtx_pressed[CONFIG_KBS_MATRIX_ROWS];
+static uint32_t mtx_fresh[CONFIG_KBS_MATRIX_ROWS];
+static uint32_t mtx_reported[CONFIG_KBS_MATRIX_ROWS];
+/* Reported keys counted against the rollover limit */
+static uint8_t mtx_reported_keys;
+/* Latency timestamp of the first key event of the scan */
+static uint32_t mtx_event;
+/* Scan evaluation is queued */
+static bool mtx_scan_queued;
+static struct k_spinlock mtx_lock;
+
+static void mtx_scan_settled(struct k_work *work);
+static K_WORK_DEFINE(mtx_scan_work, mtx_scan_settled);
+
+#define KBS_MATRIX_6KRO_KEYS		6U
+/* kscan reports every change of a scan back to back from its cooperative
+ * polling thread. The scan is evaluated by a cooperative work queue of its
+ * own, which runs as soon as the polling thread waits for the next scan,
+ * ahead of the EC tasks and regardless of system work queue load.
+ */
+#define KBS_MATRIX_SCAN_STACK_SIZE	1024
+#define KBS_MATRIX_SCAN_PRIORITY	K_PRIO_COOP(4)
+
+static K_THREAD_STACK_DEFINE(mtx_scan_stack, KBS_MATRIX_SCAN_STACK_SIZE);
+static struct k_work_q mtx_scan_wq;
+
 static inline bool numlock_on(void)
 {
 	return ((kscan_flags >> KBS_NUMLOCK_DOWN_POS) & 0x1) == 0x1;
@@ -348,6 +255,9 @@ int kbs_matrix_init(kbs_matrix_callback callback, uint8_t *initial_set)
 	}
 
 	kbs_write_typematic(dflt_typematic_delay_rate);
+	k_work_queue_start(&mtx_scan_wq, mtx_scan_stack,
+			   K_THREAD_STACK_SIZEOF(mtx_scan_stack),
+			   KBS_MATRIX_SCAN_PRIORITY, NULL);
 	kscan_config(kscan_dev, kscan_callback);
 
 	k_timer_init(&typematic_timer, typematic_callback, NULL);
@@ -372,11 +282,27 @@ int kbs_matrix_init(kbs_matrix_callback callback, uint8_t *initial_set)
 	keyseq_det[KEYSEQ_CUSTOM0].modifiers = KBS_SHIFT_DOWN | KBS_ALT_DOWN;
 	keyseq_det[KEYSEQ_CUSTOM1].trigger_key = CONFIG_EARLY_KEYSEQ_CUSTOM1;
 	keyseq_det[KEYSEQ_CUSTOM1].modifiers = KBS_SHIFT_DOWN | KBS_ALT_DOWN;
+
+	for (size_t id = 0; id < KEYSEQ_COUNT; id++) {
+		k_work_init_delayable(&keyseq_hold_work[id],
+				      keyseq_hold_expired);
+	}
+
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+	keyseq_link(KEYSEQ_TIMEOUT);
+	keyseq_link(KEYSEQ_CUSTOM0);
+	keyseq_link(KEYSEQ_CUSTOM1);
+	k_mutex_unlock(&keyseq_mutex);
 #endif
 
 	return 0;
 }
 
+void kbs_matrix_set_busy_callback(kbs_matrix_busy_callback busy)
+{
+	kbs_busy = busy;
+}
+
 void kbs_write_typematic(uint8_t data)
 {
 	/* Cancel typematic timer before attempting to change settings */
@@ -389,6 +315,29 @@ void kbs_write_typematic(uint8_t data)
 
 void kbs_keyboard_enable(void)
 {
+	k_spinlock_key_t key;
+
+	/* Keys released while disabled are never notified */
+	k_work_cancel(&mtx_scan_work);
+	key = k_spin_lock(&mtx_lock);
+	memset(mtx_pressed, 0, sizeof(mtx_pressed));
+	memset(mtx_fresh, 0, sizeof(mtx_fresh));
+	mtx_scan_queued = false;
+	k_spin_unlock(&mtx_lock, key);
+	memset(mtx_reported, 0, sizeof(mtx_reported));
+	mtx_reported_keys = 0U;
+#ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
+	for (size_t i = 0; i < ARRAY_SIZE(keyseq_held_keys); i++) {
+		atomic_clear(&keyseq_held_keys[i]);
+	}
+
+	/* Sequences armed before are no longer held */
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+	keyseq_last_key = 0U;
+	keyseq_release();
+	k_mutex_unlock(&keyseq_mutex);
+#endif
+
 	kscan_enable_callback(kscan_dev);
 	kbs_write_typematic(dflt_typematic_delay_rate);
 }
@@ -435,254 +384,47 @@ static void update_modifier_keys(uint8_t key_num, bool pressed)
 	}
 }
 
-static void get_print_screen_scode(struct scan_code *sc2, bool pressed,
-				   bool ctrl_pressed, bool alt_pressed,
-				   bool shift_pressed)
-{
-	/* Regular print screen functionality */
-	if (!shift_pressed && !ctrl_pressed && !alt_pressed) {
-		if (pressed) {
-			sc2->code[0] = 0xe0U;
-			sc2->code[1] = 0x12U;
-			sc2->code[2] = 0xe0U;
-			sc2->code[3] = 0x7cU;
-			sc2->len = 4U;
-			sc2->typematic = true;
-		} else {
-			sc2->code[0] = 0xe0U;
-			sc2->code[1] = 0xf0U;
-			sc2->code[2] = 0x7cU;
-			sc2->code[3] = 0xe0U;
-			sc2->code[4] = 0xf0U;
-			sc2->code[5] = 0x12U;
-			sc2->len = 6U;
-			sc2->typematic = false;
-		}
-	/* emulation of sys-req */
-	} else if (alt_pressed) {
-		if (pressed) {
-			sc2->code[0] = 0x84U;
-			sc2->len = 1U;
-			sc2->typematic = true;
-		} else {
-			sc2->code[0] = 0xf0U;
-			sc2->code[1] = 0x84U;
-			sc2->len = 2U;
-			sc2->typematic = false;
-		}
-	} else { /* ctrl or shift down */
-		if (pressed) {
-			sc2->code[0] = 0xe0U;
-			sc2->code[1] = 0x7cU;
-			sc2->len = 2U;
-			sc2->typematic = true;
-		} else {
-			sc2->code[0] = 0xf0;
-			sc2->code[1] = 0xe0;
-			sc2->code[2] = 0x7c;
-			sc2->len = 3U;
-			sc2->typematic = false;
-		}
-	}
-}
-
-/* Pause/break have neither typematic nor break code */
-static void get_pause_scode(struct scan_code *sc2,
-			    bool ctrl_pressed)
-{
-	/* Break scan code 2 */
-	if (ctrl_pressed) {
-		sc2->code[0] = 0xe0U;
-		sc2->code[1] = 0x7eU;
-		sc2->code[2] = 0xe0U;
-		sc2->code[3] = 0xf0U;
-		sc2->code[4] = 0x7eU;
-		sc2->len = 5U;
-	} else {
-		/* Pause scan code 2 */
-		sc2->code[0] = 0xe1U;
-		sc2->code[1] = 0x14U;
-		sc2->code[2] = 0x77U;
-		sc2->code[3] = 0xe1U;
-		sc2->code[4] = 0xf0U;
-		sc2->code[5] = 0x14U;
-		sc2->code[6] = 0xf0U;
-		sc2->code[7] = 0x77U;
-		sc2->len = 8U;
-	}
-
-	sc2->typematic = false;
-}
-
-/* This function is only exercised in keyboards with numlock button */
-void get_numpad_scode(uint8_t key_num, struct scan_code *sc2,
-		      bool pressed)
-{
-	uint8_t scan_code = 0x0U;
-	/* This switch represents the keys in for keyboards without
-	 * real numeric keys. But I guess the scame scan codes
-	 * can be used with keyboards containing numeric pads
-	 */
-	switch (key_num) {
-	case KM_KEY_7:
-		scan_code = 0x6CU;
-		break;
-	case KM_KEY_8:
-		scan_code = 0x75U;
-		break;
-	case KM_KEY_9:
-		scan_code = 0x7DU;
-		break;
-	case KM_KEY_0:
-		scan_code = 0x4AU;
-		break;
-	case KM_KEY_U_4:
-		scan_code = 0x6BU;
-		break;
-	case KM_KEY_5_I:
-		scan_code = 0x73U;
-		break;
-	case KM_KEY_6_O:
-		scan_code = 0x74U;
-		break;
-	case KM_KEY_P_MUL:
-		scan_code = 0x7CU;
-		break;
-	case KM_KEY_1_J:
-		scan_code = 0x69U;
-		break;
-	case KM_KEY_2_K:
-		scan_code = 0x72U;
-		break;
-	case KM_KEY_3_L:
-		scan_code = 0x7AU;
-		break;
-	case KM_KEY_MINUS_SEMI:
-		scan_code = 0x4EU;
-		break;
-	case KM_KEY_0_M:
-		scan_code = 0x70U;
-		break;
-	case KM_KEY_DOT:
-		scan_code = 0x71U;
-		break;
-	case KM_KEY_PLUS_SLASH:
-		scan_code = 0x79U;
-		break;
-	}
-
-	/* We already know the numeric keys are a single byte */
-	if (scan_code != 0U) {
-		if (pressed) {
-			sc2->code[0] = scan_code;
-			sc2->len++;
-			sc2->typematic = true;
-
-		} else {
-			sc2->code[0] = 0xF0U;
-			sc2->code[1] = scan_code;
-			sc2->len = 2U;
-			sc2->typematic = false;
-		}
-	} else {
-		/* User just pressed numlock */
-		sc2->len = 0U;
-	}
-}
-
-/* Funnel function that will retrieve several kind of scan codes.
- * keynum represents the key station
- * sc2 is an out parameter to be filled here
- * typematic indicates if a specific keymap has typematic behavior.
- * This is an out parameter
- * pressed is either make or break
+/* Make and break codes come from tables generated by
+ * scripts/gen_kbs_scancode_tbl.py, already translated for the scan code set
+ * selected by the host. Modifiers only select the numlock, print screen and
+ * pause/break variants.
  */
-static void get_scan_code(uint8_t key_num, struct scan_code *sc2, bool pressed)
+static const struct scan_code *get_scan_code(uint8_t key_num, bool pressed)
 {
+	uint8_t set = *scan_code_set;
+	uint8_t row = key_num;
 
 	update_modifier_keys(key_num, pressed);
 
-	bool ctrl_down = ctrl_pressed();
-	bool alt_down = alt_pressed();
-	bool shift_down = shift_pressed();
-
-	/* This is exclusively used for keyboards without numpad.
-	 * We can add a property to the keyboard implementatoin indicating
-	 * whether it has numpad.
-	 */
-
-	if (numlock_on()) {
-		get_numpad_scode(key_num, sc2, pressed);
-		/* If the length is zero, then allow the execution
-		 * to continue. This is because numlock may engaged,
-		 * but the user is pressing other keys.
-		 */
-		if (sc2->len != 0U) {
-			return;
-		}
+	if (key_num >= KBS_SC_KEYS ||
+	    set < SCAN_CODE_SET1 || set > SCAN_CODE_SET2) {
+		return NULL;
 	}
 
-	if (key_num == KM_PRINT_SCREEN) {
-		/* Print screen plus other key combinations */
-		get_print_screen_scode(sc2, pressed, ctrl_down,
-				       alt_down, shift_down);
-	} else if (key_num == KM_PAUSE) {
-		/* Pause/break scancodes */
-		get_pause_scode(sc2, ctrl_down);
-	} else {
-		/* These are regular keys in the QWERTY key without any
-		 * esoteric key combination
-		 */
-		uint8_t i = 0U;
-
-		/* Protect against overflow */
-		if (key_num >= MAX_SC2_TABLE_SIZE) {
-			sc2->len = 0U;
-			return;
-		}
-		const struct scan_code *code = &scan_code2[key_num];
-
-		if (code->len != 0U) {
-			if (pressed) {
-				sc2->typematic = true;
-				while (i < code->len) {
-					sc2->code[i] = code->code[i];
-					i++;
-				}
-
-				sc2->len = i;
-			} else {
-				sc2->typematic = false;
-				int j = 0;
-
-				while (i < code->len) {
-					/* Extended scan codes  change
-					 * when numlock and shift are combined.
-					 * Especially for kb with keypad.
-					 * This feature can be extended in
-					 * in your custom kb implementaton.
-					 * These key combinations are ignored
-					 * here.
-					 */
-					if (code->code[i] != 0xE0) {
-						sc2->code[j] = 0xF0U;
-						j++;
-					}
-					sc2->code[j++] = code->code[i++];
-				}
-
-				sc2->len = j;
-			}
+	/* This is exclusively used for keyboards without numpad */
+	if (numlock_on() && kbs_sc_numpad_row[key_num] != 0U) {
+		row = kbs_sc_numpad_row[key_num];
+	} else if (key_num == KM_PRINT_SCREEN) {
+		if (alt_pressed()) {
+			/* emulation of sys-req */
+			row = KBS_SC_ROW_PRTSC_ALT;
+		} else if (ctrl_pressed() || shift_pressed()) {
+			row = KBS_SC_ROW_PRTSC_CTRL_SHIFT;
+		} else {
+			row = KBS_SC_ROW_PRTSC;
 		}
+	} else if (key_num == KM_PAUSE) {
+		row = ctrl_pressed() ? KBS_SC_ROW_PAUSE_CTRL : KBS_SC_ROW_PAUSE;
 	}
+
+	return &kbs_sc_tbl[set - SCAN_CODE_SET1][row]
+			  [pressed ? KBS_SC_MAKE : KBS_SC_BREAK];
 }
 
-static void make_key(uint8_t key_num)
+static void make_key(uint8_t key_num, uint32_t event)
 {
-	struct scan_code sc2;
-
-	memsets(&sc2, 0, sizeof(sc2));
-	sc2.typematic = false;
+	const struct scan_code *code = NULL;
+	struct fn_data data;
 
 	/* Stop if we are in a current typematic state and
 	 * a new key has been pressed whitout releasing the
@@ -697,14 +439,13 @@ static void make_key(uint8_t key_num)
 
 	/* Fn + key presed combination */
 	if (fn_with_valid_keynum(key_num)) {
-		struct fn_data data;
-
-		/* Retrieve data from custom keyboard implementation */
-		keymap_get_fnkey(keymap_api, key_num, &data, true);
+		/* Retrieve data already translated by the generated keymap */
+		keymap_get_fnkey(keymap_api, key_num, *scan_code_set, &data,
+				 true);
 		if (data.type == FN_SCAN_CODE) {
-			sc2 = data.sc;
-			if (sc2.code[0] == SC_UNMAPPED)
+			if (data.sc.code[0] == SC_UNMAPPED)
 				return;
+			code = &data.sc;
 		} else {
 			/* Send an SCI. Remember to add 0x80 for SCI break*/
 			LOG_DBG("Sci %x", data.sci_code);
@@ -714,29 +455,19 @@ static void make_key(uint8_t key_num)
 		}
 	} else { /* Handle ordinary key presses, qwerty keys + numlock */
 		hotkey_detected = false;
-		get_scan_code(key_num, &sc2, true);
+		code = get_scan_code(key_num, true);
 	}
 
-	if (sc2.len == 0U) {
+	if (!code || code->len == 0U) {
 		LOG_DBG("Invalid make code for key num = %d", key_num);
 		return;
 	}
 
-	/* Translate keys from scancode 2 to scancode 1 */
-	make_tpmatic_code.len = 0U;
-
-	for (int i = 0; i < sc2.len; i++) {
-		uint8_t value = sc2.code[i];
-
-		if (translate_key(*scan_code_set, &value) == 0U &&
-		    make_tpmatic_code.len  < MAX_SCAN_CODE_LEN) {
-			make_tpmatic_code.code[make_tpmatic_code.len++] = value;
-		}
-	}
-
-	kbs_callback(make_tpmatic_code.code, make_tpmatic_code.len);
+	make_tpmatic_code = *code;
+	kbs_callback(make_tpmatic_code.code, make_tpmatic_code.len, event,
+		     false);
 
-	if (sc2.typematic) {
+	if (make_tpmatic_code.typematic) {
 		/* Start timer to send scan codes while holding down
 		 * the current key
 		 */
@@ -746,13 +477,10 @@ static void make_key(uint8_t key_num)
 	}
 }
 
-static void break_key(uint8_t key_num)
+static void break_key(uint8_t key_num, uint32_t event)
 {
-	struct scan_code sc2;
-	struct scan_code break_code;
-
-	memsets(&sc2, 0, sizeof(sc2));
-	sc2.typematic = false;
+	const struct scan_code *code = NULL;
+	struct fn_data data;
 
 	k_timer_stop(&typematic_timer);
 
@@ -763,46 +491,185 @@ static void break_key(uint8_t key_num)
 
 	/* Fn + key release combination */
 	if (fn_with_valid_keynum(key_num)) {
-		struct fn_data data;
-
-		/* Retrieve data from custom keyboard implementation */
-		keymap_get_fnkey(keymap_api, key_num, &data, false);
+		/* Retrieve data already translated by the generated keymap */
+		keymap_get_fnkey(keymap_api, key_num, *scan_code_set, &data,
+				 false);
 		if (data.type == FN_SCAN_CODE) {
-			sc2 = data.sc;
-			if (sc2.code[0] == SC_UNMAPPED)
+			if (data.sc.code[0] == SC_UNMAPPED)
 				return;
+			code = &data.sc;
 		}
 	} else { /* Handle ordinary key releases, qwerty keys + numlock */
-		get_scan_code(key_num, &sc2, false);
+		code = get_scan_code(key_num, false);
 	}
 
-	if (sc2.len == 0U) {
+	if (!code || code->len == 0U) {
 		LOG_DBG("Invalid break code for keynum = %d", key_num);
 		return;
 	}
 
-	/* Translate keys from scancode 2 to scancode 1 */
-	break_code.len = 0U;
+	kbs_callback(code->code, code->len, event, true);
+}
+
+static void typematic_callback(struct k_timer *timer)
+{
+	/* Skip the repeat if the previous one was not delivered yet */
+	if (kbs_busy && kbs_busy()) {
+		return;
+	}
+
+	kbs_callback(make_tpmatic_code.code, make_tpmatic_code.len,
+		     kb_lat_key_event(), false);
+}
+
+static bool is_modifier(uint8_t last_key)
+{
+	switch (last_key) {
+	case KM_LCNTRL_KEY:
+	case KM_RCNTRL_KEY:
+	case KM_LALT_KEY:
+	case KM_RALT_KEY:
+	case KM_LSHIFT_KEY:
+	case KM_RSHIFT_KEY:
+	case KM_NUMLOCK_KEY:
+	case KM_SCLOCK_KEY:
+		return true;
+	default:
+		break;
+	}
+
+	return false;
+}
+
+#ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
+/* Must be called with keyseq_mutex held */
+static void keyseq_link(uint8_t id)
+{
+	uint8_t key = keyseq_det[id].trigger_key;
+
+	keyseq_next[id] = keyseq_head[key];
+	keyseq_head[key] = id + 1;
+}
+
+/* Must be called with keyseq_mutex held */
+static void keyseq_unlink(uint8_t id)
+{
+	uint8_t *link = &keyseq_head[keyseq_det[id].trigger_key];
+
+	while (*link && *link != id + 1) {
+		link = &keyseq_next[*link - 1];
+	}
 
-	for (int i = 0; i < sc2.len; i++) {
-		uint8_t value = sc2.code[i];
+	if (*link) {
+		*link = keyseq_next[id];
+		keyseq_next[id] = 0;
+	}
+}
 
-		if (translate_key(*scan_code_set, &value) == 0U &&
-		    break_code.len  < MAX_SCAN_CODE_LEN) {
-			break_code.code[break_code.len++] = value;
+static bool keyseq_held(const struct kbs_keyseq *seq)
+{
+	if ((kscan_flags & seq->modifiers) != seq->modifiers) {
+		return false;
+	}
 
+	if (seq->trigger_key &&
+	    !atomic_test_bit(keyseq_held_keys, seq->trigger_key)) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(seq->chord); i++) {
+		if (seq->chord[i] &&
+		    !atomic_test_bit(keyseq_held_keys, seq->chord[i])) {
+			return false;
 		}
 	}
 
-	kbs_callback(break_code.code, break_code.len);
+	return true;
 }
 
-static void typematic_callback(struct k_timer *timer)
+/* Must be called with keyseq_mutex held */
+static void keyseq_notify(uint8_t id)
 {
-	kbs_callback(make_tpmatic_code.code, make_tpmatic_code.len);
+	LOG_INF("%s keyseq %d detected ", __func__, id);
+	keyseq_det[id].detected = true;
+	keyseq_active[id] = true;
+	keyseq_armed++;
+
+	if (keyseq_det[id].handler) {
+		keyseq_det[id].handler(true);
+	}
+}
+
+/* Must be called with keyseq_mutex held */
+static void keyseq_disarm(uint8_t id)
+{
+	if (keyseq_pending[id]) {
+		k_work_cancel_delayable(&keyseq_hold_work[id]);
+		keyseq_pending[id] = false;
+		keyseq_armed--;
+	} else if (keyseq_active[id]) {
+		keyseq_active[id] = false;
+		keyseq_armed--;
+		if (keyseq_det[id].handler) {
+			keyseq_det[id].handler(false);
+		}
+	}
+}
+
+static void keyseq_hold_expired(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	uint8_t id = dwork - keyseq_hold_work;
+
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+
+	/* Work may run right after the sequence was cancelled */
+	if (keyseq_pending[id]) {
+		keyseq_pending[id] = false;
+		keyseq_armed--;
+		if (keyseq_held(&keyseq_det[id])) {
+			keyseq_notify(id);
+		}
+	}
+
+	k_mutex_unlock(&keyseq_mutex);
+}
+
+/* Must be called with keyseq_mutex held */
+static void keyseq_match(uint8_t key)
+{
+	for (uint8_t n = keyseq_head[key]; n; n = keyseq_next[n - 1]) {
+		uint8_t id = n - 1;
+
+		if (keyseq_active[id] || keyseq_pending[id] ||
+		    !keyseq_held(&keyseq_det[id])) {
+			continue;
+		}
+
+		if (keyseq_det[id].hold_ms) {
+			keyseq_pending[id] = true;
+			keyseq_armed++;
+			k_work_reschedule(&keyseq_hold_work[id],
+					  K_MSEC(keyseq_det[id].hold_ms));
+		} else {
+			keyseq_notify(id);
+		}
+	}
+}
+
+/* Must be called with keyseq_mutex held */
+static void keyseq_release(void)
+{
+	/* Releasing any key of a sequence ends it, modifiers and chord keys
+	 * included, so every armed sequence is checked whatever its trigger.
+	 */
+	for (uint8_t id = 0; keyseq_armed && id < KEYSEQ_COUNT; id++) {
+		if (!keyseq_held(&keyseq_det[id])) {
+			keyseq_disarm(id);
+		}
+	}
 }
 
-#ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
 bool kbs_keyseq_boot_detect(enum kbs_keyseq_type type)
 {
 	LOG_INF("%s type:%d detected: %d", __func__, type,
@@ -814,21 +681,85 @@ bool kbs_keyseq_boot_detect(enum kbs_keyseq_type type)
 int kbs_keyseq_define(uint8_t modifiers, uint8_t key,
 		      kbs_key_seq_detected callback)
 {
-	/* We only allow 1 runtime hot-key sequence */
+	int ret = 0;
+
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+
+	/* Legacy runtime slot, use kbs_keyseq_add() for more sequences */
 	if (keyseq_det[KEYSEQ_RUNTIME].trigger_key != 0) {
 		LOG_ERR("%s key trigger already defined", __func__);
+		ret = -EINVAL;
+	} else if (keyseq_det[KEYSEQ_RUNTIME].handler != 0) {
+		LOG_ERR("%s callback already registered", __func__);
+		ret = -EINVAL;
+	} else {
+		LOG_INF("%s %x %d", __func__, modifiers, key);
+		keyseq_det[KEYSEQ_RUNTIME].trigger_key = key;
+		keyseq_det[KEYSEQ_RUNTIME].modifiers = modifiers;
+		keyseq_det[KEYSEQ_RUNTIME].handler = callback;
+		keyseq_link(KEYSEQ_RUNTIME);
+	}
+
+	k_mutex_unlock(&keyseq_mutex);
+
+	return ret;
+}
+
+int kbs_keyseq_add(const struct kbs_keyseq *seq)
+{
+	int id;
+
+	if (!seq || !seq->handler || (!seq->trigger_key && !seq->modifiers)) {
+		LOG_ERR("%s invalid key sequence", __func__);
 		return -EINVAL;
 	}
 
-	if (keyseq_det[KEYSEQ_RUNTIME].handler != 0) {
-		LOG_ERR("%s callback already registered", __func__);
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+
+	/* Runtime key sequences in use always have a handler */
+	for (id = KEYSEQ_MAX_SEQ_COUNT; id < KEYSEQ_COUNT; id++) {
+		if (!keyseq_det[id].handler) {
+			break;
+		}
+	}
+
+	if (id == KEYSEQ_COUNT) {
+		k_mutex_unlock(&keyseq_mutex);
+		LOG_ERR("%s no free key sequence", __func__);
+		return -ENOMEM;
+	}
+
+	keyseq_det[id] = *seq;
+	keyseq_det[id].detected = false;
+	keyseq_active[id] = false;
+	keyseq_link(id);
+
+	k_mutex_unlock(&keyseq_mutex);
+
+	LOG_INF("%s %d: %x %d", __func__, id, seq->modifiers,
+		seq->trigger_key);
+
+	return id;
+}
+
+int kbs_keyseq_remove(int id)
+{
+	if (id < KEYSEQ_MAX_SEQ_COUNT || id >= KEYSEQ_COUNT) {
 		return -EINVAL;
 	}
 
-	LOG_INF("%s %x %d", __func__, modifiers, key);
-	keyseq_det[KEYSEQ_RUNTIME].trigger_key = key;
-	keyseq_det[KEYSEQ_RUNTIME].modifiers = modifiers;
-	keyseq_det[KEYSEQ_RUNTIME].handler = callback;
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+
+	if (!keyseq_det[id].handler) {
+		k_mutex_unlock(&keyseq_mutex);
+		return -EINVAL;
+	}
+
+	keyseq_disarm(id);
+	keyseq_unlink(id);
+	memset(&keyseq_det[id], 0, sizeof(keyseq_det[id]));
+
+	k_mutex_unlock(&keyseq_mutex);
 
 	return 0;
 }
@@ -846,84 +777,179 @@ int kbs_keyseq_register(enum kbs_keyseq_type index,
 	return 0;
 }
 
-static bool is_modifier(uint8_t last_key)
+static void fw_hotkeyseq_detection(bool pressed, uint8_t key)
 {
-	switch (last_key) {
-	case KM_LCNTRL_KEY:
-	case KM_RCNTRL_KEY:
-	case KM_LALT_KEY:
-	case KM_RALT_KEY:
-	case KM_LSHIFT_KEY:
-	case KM_RSHIFT_KEY:
-	case KM_NUMLOCK_KEY:
-	case KM_SCLOCK_KEY:
-		return true;
-	default:
-		break;
+	bool modifier = is_modifier(key) || key == KM_FN_KEY;
+
+	LOG_DBG("flags: %x key: %x press:%d mod:(%d %d %d)", kscan_flags, key,
+		pressed, ctrl_pressed(), alt_pressed(), shift_pressed());
+
+	atomic_set_bit_to(keyseq_held_keys, key, pressed);
+
+	k_mutex_lock(&keyseq_mutex, K_FOREVER);
+
+	if (pressed && modifier) {
+		/* Keys held at boot may be reported ahead of modifiers */
+		keyseq_match(0);
+		if (keyseq_last_key) {
+			keyseq_match(keyseq_last_key);
+		}
+	} else if (pressed) {
+		keyseq_last_key = key;
+		keyseq_match(key);
+	} else {
+		if (key == keyseq_last_key) {
+			keyseq_last_key = 0;
+		}
+
+		keyseq_release();
 	}
 
+	k_mutex_unlock(&keyseq_mutex);
+}
+#endif
+
+static inline bool mtx_counts_for_rollover(int key_num)
+{
+	return key_num != KM_FN_KEY && !is_modifier(key_num);
+}
+
+static bool mtx_rollover_exceeded(int key_num)
+{
+#ifdef CONFIG_KBS_MATRIX_6KRO
+	return mtx_counts_for_rollover(key_num) &&
+	       mtx_reported_keys >= KBS_MATRIX_6KRO_KEYS;
+#else
 	return false;
+#endif
 }
 
-static void fw_hotkeyseq_detection(bool pressed, uint8_t key)
+static void mtx_report(uint32_t row, uint32_t col, bool pressed,
+		       uint32_t event)
 {
-	static int trigger_key;
+	int key_num = keymap_get_keynum(keymap_api, col, row);
 
-	LOG_DBG("flags: %x key: %x press:%d mod:(%d %d %d)", kscan_flags, key,
-		pressed, ctrl_pressed(), alt_pressed(), shift_pressed());
+	if (pressed) {
+		if (mtx_rollover_exceeded(key_num)) {
+			LOG_DBG("Rollover exceeded key: %d", key_num);
+			return;
+		}
+
+		mtx_reported[row] |= BIT(col);
+		if (mtx_counts_for_rollover(key_num)) {
+			mtx_reported_keys++;
+		}
 
-	if (!is_modifier(key)) {
-		trigger_key = key;
+		make_key(key_num, event);
+	} else {
+		mtx_reported[row] &= ~BIT(col);
+		if (mtx_counts_for_rollover(key_num)) {
+			mtx_reported_keys--;
+		}
+
+		break_key(key_num, event);
 	}
 
-	for (uint8_t i = 0; i < ARRAY_SIZE(keyseq_det); i++) {
-		bool match_mod = ((kscan_flags & keyseq_det[i].modifiers) ==
-				   keyseq_det[i].modifiers);
+#ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
+	/* Do not consume or alter in any way */
+	fw_hotkeyseq_detection(pressed, key_num);
+#endif
+}
 
-		/* Undefined runtime hotkey */
-		if (keyseq_det[i].modifiers == 0) {
-			continue;
+/* Ghost keys are told apart against the whole scan, once the scan reported
+ * all its changes, so the keys reported do not depend on the order the scan
+ * walked the matrix.
+ */
+static void mtx_scan_settled(struct k_work *work)
+{
+	ARG_UNUSED(work);
+	uint32_t pressed[CONFIG_KBS_MATRIX_ROWS];
+	uint32_t fresh[CONFIG_KBS_MATRIX_ROWS];
+	k_spinlock_key_t key;
+	uint32_t event;
+
+	key = k_spin_lock(&mtx_lock);
+	memcpy(pressed, mtx_pressed, sizeof(pressed));
+	memcpy(fresh, mtx_fresh, sizeof(fresh));
+	memset(mtx_fresh, 0, sizeof(mtx_fresh));
+	event = mtx_event;
+	mtx_scan_queued = false;
+	k_spin_unlock(&mtx_lock, key);
+
+	/* Break codes go first, only for keys the host got the make code of */
+	for (uint32_t row = 0; row < CONFIG_KBS_MATRIX_ROWS; row++) {
+		uint32_t released = mtx_reported[row] & ~pressed[row];
+
+		for (uint32_t col = 0; released; col++) {
+			if (released & BIT(col)) {
+				released &= ~BIT(col);
+				mtx_report(row, col, false, event);
+			}
 		}
+	}
+
+#ifdef CONFIG_KBS_MATRIX_GHOST_DETECTION
+	uint32_t ghosts[CONFIG_KBS_MATRIX_ROWS];
 
-		LOG_DBG("exp_modifiers: %x exp_key_num %d",
-			keyseq_det[i].modifiers, keyseq_det[i].trigger_key);
-
-		/* Timeout hotkey is composed of modifier keys only */
-		if (match_mod && i == KEYSEQ_TIMEOUT) {
-			LOG_WRN("%s Timeout keyseq detected ", __func__);
-			keyseq_det[i].detected = true;
-			trigger_key = 0;
-		} else if (trigger_key == keyseq_det[i].trigger_key &&
-			   match_mod) {
-			LOG_INF("%s keyseq %d detected ", __func__, i);
-			keyseq_det[i].detected = true;
-			trigger_key = 0;
+	memcpy(ghosts, fresh, sizeof(ghosts));
+	kbs_matrix_ghost_filter(pressed, fresh, CONFIG_KBS_MATRIX_ROWS);
+	for (uint32_t row = 0; row < CONFIG_KBS_MATRIX_ROWS; row++) {
+		ghosts[row] &= ~fresh[row];
+		if (ghosts[row]) {
+			LOG_DBG("Ghost cols: %x row: %d", ghosts[row], row);
 		}
+	}
+#endif
 
-		if (keyseq_det[i].detected && keyseq_det[i].handler) {
-			keyseq_det[i].handler(pressed);
+	for (uint32_t row = 0; row < CONFIG_KBS_MATRIX_ROWS; row++) {
+		uint32_t made = fresh[row] & ~mtx_reported[row];
+
+		for (uint32_t col = 0; made; col++) {
+			if (made & BIT(col)) {
+				made &= ~BIT(col);
+				mtx_report(row, col, true, event);
+			}
 		}
 	}
 }
-#endif
 
 static void kscan_callback(const struct device *dev, uint32_t row,
 			   uint32_t col, bool pressed)
 {
 	ARG_UNUSED(dev);
-	int last_key =  keymap_get_keynum(keymap_api, col, row);
+	k_spinlock_key_t key;
+	bool queue;
+	int last_key;
+
+	if (row >= CONFIG_KBS_MATRIX_ROWS || col >= CONFIG_KBS_MATRIX_COLS) {
+		LOG_WRN("Key out of matrix col: %d row: %d", col, row);
+		return;
+	}
 
+	last_key = keymap_get_keynum(keymap_api, col, row);
 	LOG_DBG("Keymap: %d col: %d row: %d", last_key, col, row);
+	if (last_key < 0) {
+		return;
+	}
+
+	key = k_spin_lock(&mtx_lock);
+	queue = !mtx_scan_queued;
+	if (queue) {
+		mtx_event = kb_lat_key_event();
+		mtx_scan_queued = true;
+	}
 
 	if (pressed) {
-		make_key(last_key);
+		mtx_pressed[row] |= BIT(col);
+		mtx_fresh[row] |= BIT(col);
 	} else {
-		break_key(last_key);
+		mtx_pressed[row] &= ~BIT(col);
+		mtx_fresh[row] &= ~BIT(col);
 	}
+	k_spin_unlock(&mtx_lock, key);
 
-#ifdef CONFIG_EARLY_KEY_SEQUENCE_DETECTION
-	/* Do not consume or alter in any way */
-	fw_hotkeyseq_detection(pressed, last_key);
-#endif
+	if (queue) {
+		k_work_submit_to_queue(&mtx_scan_wq, &mtx_scan_work);
+	}
 }
 
@@ -27,7 +27,12 @@
 #define KBS_SHIFT_DOWN_POS	5U
 #define KBS_WIN_DOWN_POS	6U
 
-typedef void (*kbs_matrix_callback)(uint8_t *data, uint8_t len);
+/* Event is the key event timestamp for latency tracing, 0 if not traced.
+ * brk is set for break codes, the host must get them once it got the make.
+ */
+typedef void (*kbs_matrix_callback)(const uint8_t *data, uint8_t len,
+				    uint32_t event, bool brk);
+typedef bool (*kbs_matrix_busy_callback)(void);
 
 /**
  * @brief Initialize kscan keyboard instance representing the keyboard.
@@ -41,6 +46,17 @@ typedef void (*kbs_matrix_callback)(uint8_t *data, uint8_t len);
  */
 int kbs_matrix_init(kbs_matrix_callback callback, uint8_t *initial_set);
 
+/**
+ * @brief Register a callback reporting that previous key data is pending.
+ *
+ * Typematic repeats are skipped while the callback returns true, so the
+ * repeat rate applies to data delivered to the host and repeats never pile
+ * up while the host is stalled.
+ *
+ * @param busy Pointer to a function implemented in the caller code.
+ */
+void kbs_matrix_set_busy_callback(kbs_matrix_busy_callback busy);
+
 /**
  * @brief Write commands to kscan keyboard.
  *
@@ -103,6 +119,35 @@ bool kbs_keyseq_boot_detect(enum kbs_keyseq_type index);
 int kbs_keyseq_define(uint8_t modifiers, uint8_t key,
 		     kbs_key_seq_detected callback);
 
+/**
+ * @brief Add a runtime hot key sequence.
+ *
+ * The sequence is detected when its trigger key is pressed while its
+ * modifiers and chord keys are held, or when the last modifier is pressed
+ * while the rest is held. The handler is called with true once the whole
+ * sequence has been held for hold_ms, and with false once any of its keys,
+ * modifiers included, is released afterwards or the keyboard is enabled
+ * again. The handler is also called with false when the sequence is
+ * removed while active.
+ *
+ * @param seq the key sequence definition, copied by the driver.
+ *
+ * @retval the key sequence id on success.
+ * @retval -EINVAL if the definition is not valid.
+ * @retval -ENOMEM if all runtime key sequences are in use.
+ */
+int kbs_keyseq_add(const struct kbs_keyseq *seq);
+
+/**
+ * @brief Remove a runtime hot key sequence.
+ *
+ * @param id the key sequence id returned by kbs_keyseq_add().
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the id is not a runtime key sequence in use.
+ */
+int kbs_keyseq_remove(int id);
+
 /**
  * @brief Register of notification from specific key sequence.
  *
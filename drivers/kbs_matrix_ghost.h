@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef KBS_MATRIX_GHOST_H
+#define KBS_MATRIX_GHOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zephyr/sys/math_extras.h>
+#include <zephyr/sys/util.h>
+
+/**
+ * @brief Check if a pressed key closes a ghost rectangle.
+ *
+ * A key closes a ghost rectangle when its row shares its column and at least
+ * another pressed column with any other row. Such key can't be told apart
+ * from a phantom key reported by matrices without diodes.
+ *
+ * @param pressed column bitmap of the pressed keys, one per row.
+ * @param rows number of rows in the matrix.
+ * @param row row of the key.
+ * @param col column of the key.
+ *
+ * @retval true if the key may be a phantom key.
+ */
+static inline bool kbs_matrix_ghost_key(const uint32_t *pressed,
+					uint32_t rows, uint32_t row,
+					uint32_t col)
+{
+	for (uint32_t r = 0; r < rows; r++) {
+		uint32_t common = pressed[r] & pressed[row];
+
+		if (r != row && (common & BIT(col)) && (common & ~BIT(col))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Drop the ghost keys among the keys pressed during a scan.
+ *
+ * Every new key is checked against the whole scan snapshot, so the keys kept
+ * do not depend on the order the scan reported them. When a real key and a
+ * phantom key show up in the same scan both are dropped.
+ *
+ * @param pressed column bitmap of the pressed keys, one per row.
+ * @param fresh column bitmap of the keys pressed during the scan, one per
+ *        row. Ghost keys are cleared on return.
+ * @param rows number of rows in the matrix.
+ */
+static inline void kbs_matrix_ghost_filter(const uint32_t *pressed,
+					   uint32_t *fresh, uint32_t rows)
+{
+	for (uint32_t row = 0; row < rows; row++) {
+		uint32_t cols = fresh[row];
+
+		while (cols) {
+			uint32_t col = u32_count_trailing_zeros(cols);
+
+			cols &= ~BIT(col);
+			if (kbs_matrix_ghost_key(pressed, rows, row, col)) {
+				fresh[row] &= ~BIT(col);
+			}
+		}
+	}
+}
+
+#endif /* KBS_MATRIX_GHOST_H */
@@ -4,10 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/peci.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/shell/shell.h>
 #include "board_config.h"
 #include "errno.h"
 #include <soc.h>
@@ -21,7 +23,13 @@
 #define PECI_HOST_BITRATE_KBPS  1000u
 
 #define PECI_CONFIGINDEX_PL4OFFSET	72u
+#define PECI_CONFIGINDEX_PKG_ID	0u
 #define PECI_CONFIGINDEX_TJMAX  16u
+#define PECI_CONFIGINDEX_PWR_SKU_LOW	28u
+#define PECI_CONFIGINDEX_PWR_SKU_HIGH	29u
+#define PECI_CONFIGINDEX_PWR_SKU_UNIT	30u
+#define PECI_CONFIGINDEX_WAKE_ON_PECI	5u
+#define PECI_WAKE_ON_PECI_PARAM	1u
 #define PECI_CONFIGHOSTID       0u
 #define PECI_CONFIGPARAM        0u
 #define PECI_CFG_WRPKG_AWFCS    8u
@@ -37,6 +45,9 @@
 #define PECI_RETRY_CNT		3
 #define PECI_RETRY_WAIT		1 /* 1 milli sec */
 
+/* Pause of a failing target grows up to 8 times PECI_BREAKER_PAUSE_MS */
+#define PECI_BREAKER_PAUSE_SHIFT_MAX	3
+
 /* Offsets in rx buffer */
 #define PECI_RX_BUF_RESP_OFFSET	0
 #define PECI_RX_BUF_TJMAX_OFFSET 3
@@ -79,7 +90,7 @@
 #define OOB_PECI_RESP_SIZE	1U
 
 LOG_MODULE_REGISTER(peci_interface, CONFIG_PECIHUB_LOG_LEVEL);
-K_MUTEX_DEFINE(trans_mutex);
+K_SEM_DEFINE(peci_sched_sem, 0, 1);
 
 struct espi_oob_header {
 } __packed;
@@ -105,6 +116,52 @@ struct espi_oob_peci_resp_msg {
 	uint8_t data[PECI_DATA_BUF_LEN_MAX];
 } __packed;
 
+/* Bus or PECI over eSPI session serving back to back requests to the
+ * same target.
+ */
+struct peci_session {
+	uint8_t addr;
+	bool oob;
+	/* Target is paused, only critical requests probe it */
+	bool paused;
+	int status;
+};
+
+/* Pending requests per priority, only the scheduler thread accesses PECI.
+ * A single PECI over eSPI request waits for the PCH response in oob_busy,
+ * so the OOB manager never holds requests the scheduler could reorder.
+ * Retries wait for their backoff in delayed.
+ */
+static struct {
+	sys_slist_t queue[PECI_PRIO_COUNT];
+	struct peci_req *oob_busy;
+	sys_slist_t delayed;
+	struct k_spinlock lock;
+	k_tid_t tid;
+} sched;
+
+/* Health of a PECI target, protected by the sched lock */
+struct peci_health {
+	uint8_t addr;
+	/* Requests failed in a row */
+	uint8_t failures;
+	/* Requests are rejected until this uptime in ms */
+	int64_t open_until;
+	bool wake_on_peci;
+	bool wake_busy;
+	struct peci_health_stats stats;
+	/* WrPkgConfig toggling wake on PECI */
+	struct peci_req wake_req;
+	struct peci_msg wake_msg;
+	uint8_t wake_buf[TX_BUF_START_OFFSET + PECI_CFG_WRPKG_AWFCS + 1];
+	uint8_t wake_resp[PECI_WR_PKG_RD_LEN];
+};
+
+static struct peci_health health[] = {
+	[CPU] = { .addr = PECI_CPU_ADDR },
+	[GPU] = { .addr = PECI_GPU_ADDR },
+};
+
 static const struct device *peci_dev;
 static bool peci_initialized;
 static uint8_t cpu_tjmax;
@@ -220,15 +277,58 @@ static bool is_peci_over_espi_en(void)
 
 	return peci_over_espi_en;
 }
-static int peci_wire_transfer(const struct device *dev, struct peci_msg *msg)
+
+static struct peci_health *peci_health_of(uint8_t addr)
+{
+	for (int i = 0; i < ARRAY_SIZE(health); i++) {
+		if (health[i].addr == addr) {
+			return &health[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool peci_health_paused(uint8_t addr)
 {
-	/* Skip peci access when CPU in C10 state */
-	if (gpio_read_pin(CPU_C10_GATE) == LOW) {
-		LOG_DBG("Skip peci in c10");
-		return -EHOSTDOWN;
+	struct peci_health *hp = peci_health_of(addr);
+	k_spinlock_key_t key;
+	bool paused;
+
+	if (!hp) {
+		return false;
 	}
 
-	return peci_transfer(peci_dev, msg);
+	key = k_spin_lock(&sched.lock);
+	paused = hp->open_until > k_uptime_get();
+	k_spin_unlock(&sched.lock, key);
+
+	return paused;
+}
+
+/* PECI over eSPI is supported only for CPU. For
+ * others (like GPU), only legacy PECI is supported
+ */
+static bool peci_over_oob(uint8_t addr)
+{
+	return is_peci_over_espi_en() && (addr == PECI_CPU_ADDR);
+}
+
+static void peci_session_open(struct peci_session *session, uint8_t addr)
+{
+	session->addr = addr;
+	session->status = 0;
+	session->oob = peci_over_oob(addr);
+	session->paused = peci_health_paused(addr);
+
+	if (!peci_initialized && !session->oob) {
+		LOG_ERR("PECI not initialized");
+		session->status = -ENODEV;
+	} else if (!session->oob && gpio_read_pin(CPU_C10_GATE) == LOW) {
+		/* Skip peci access when CPU in C10 state */
+		LOG_DBG("Skip peci in c10");
+		session->status = -EHOSTDOWN;
+	}
 }
 
 uint8_t peci_calc_awfcs(uint8_t *peci_buffer, uint8_t awfcs_len)
@@ -256,179 +356,882 @@ uint8_t peci_calc_awfcs(uint8_t *peci_buffer, uint8_t awfcs_len)
 	return peci_awfcs;
 }
 
-static int espioob_peci_transfer(struct peci_msg *msg)
+/* Builds the PECI over eSPI OOB request, returns the OOB packet length */
+static uint8_t espioob_peci_req_init(struct espi_oob_peci_req_msg *oob_req,
+				     struct peci_msg *msg)
 {
-	struct espi_oob_peci_req_msg oob_req;
-	struct espi_oob_peci_resp_msg oob_resp;
-	struct espi_oob_packet req_pckt;
-	struct espi_oob_packet resp_pckt;
 	uint8_t oob_byte_cnt =  OOB_PECI_REQ_HDR_SIZE + msg->tx_buffer.len;
-	int ret;
 
 	LOG_DBG("%s:Msg TxLen-%d, RxLen-%d", __func__,
 			msg->tx_buffer.len, msg->rx_buffer.len);
-	oob_req.oob_dest_addr = PCH_OOB_PECI_SLV_ADDR;
-	oob_req.oob_cmd_code = PECI_OOB_CMD_CODE;
-	oob_req.oob_byte_cnt = oob_byte_cnt;
-	oob_req.oob_src_addr = EC_OOB_SLV_ADDR;
-	oob_req.peci_addr = msg->addr;
-	oob_req.peci_wr_len = msg->tx_buffer.len;
-	oob_req.peci_rd_len = msg->rx_buffer.len;
-	oob_req.peci_cmd_code = msg->cmd_code;
+	oob_req->oob_dest_addr = PCH_OOB_PECI_SLV_ADDR;
+	oob_req->oob_cmd_code = PECI_OOB_CMD_CODE;
+	oob_req->oob_byte_cnt = oob_byte_cnt;
+	oob_req->oob_src_addr = EC_OOB_SLV_ADDR;
+	oob_req->peci_addr = msg->addr;
+	oob_req->peci_wr_len = msg->tx_buffer.len;
+	oob_req->peci_rd_len = msg->rx_buffer.len;
+	oob_req->peci_cmd_code = msg->cmd_code;
 
 	/* Tx length includes peci code. So copy len-1 byte as data */
 	if (msg->tx_buffer.len > 1) {
-		memcpys(oob_req.data, msg->tx_buffer.buf,
+		memcpys(oob_req->data, msg->tx_buffer.buf,
 					msg->tx_buffer.len - 1);
 	}
 
-	req_pckt.buf = (uint8_t *)&oob_req;
-	req_pckt.len = OOB_PACKET_HEADER_SIZE + oob_byte_cnt - 1;
-	resp_pckt.buf = (uint8_t *)&oob_resp;
-	resp_pckt.len = sizeof(oob_resp);
+	return OOB_PACKET_HEADER_SIZE + oob_byte_cnt - 1;
+}
+
+static int espioob_peci_resp_copy(struct peci_msg *msg,
+				  struct espi_oob_peci_resp_msg *oob_resp)
+{
+	int ret;
+
+	/* Response length include peci command code and response code.
+	 * So exclude 2 byte for data.
+	 */
+	if (oob_resp->oob_byte_cnt > 2) {
+		ret = memcpys(msg->rx_buffer.buf, oob_resp->data,
+					oob_resp->oob_byte_cnt - 2);
+		if (ret) {
+			LOG_ERR("Failed while copying response buffer");
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int peci_session_transfer(struct peci_session *session,
+				 struct peci_msg *msg)
+{
+	if (session->status) {
+		return session->status;
+	}
+
+	return peci_transfer(peci_dev, msg);
+}
+
+/* Prepares the command to be retried according to its completion code */
+static void peci_resp_retry(struct peci_msg *msg, uint8_t peci_resp)
+{
+	switch (peci_resp) {
+	case PECI_CC_RSP_TIMEOUT:
+	case PECI_CC_OUT_OF_RESOURCES_TIMEOUT:
+		/* Retry cmd since processor unable to generate response
+		 * ontime or unable to allocate resources required to
+		 * service the cmd.
+		 */
+		msg->tx_buffer.buf[PECI_TX_BUF_HOSTIDRETRY_OFFSET] |=
+					PECI_RETRY_EN;
+		break;
+	case PECI_CC_RESOURCES_LOWPWR_TIMEOUT:
+		/* Resources required to service cmd are in low power
+		 * mode, wake on PECI is enabled before the retry.
+		 */
+		break;
+	case PECI_CC_ILLEGAL_REQUEST:
+		/* Invalid or illegal Request */
+		break;
+	default:
+		LOG_WRN("Invalid peci response %x", peci_resp);
+		break;
+	}
+}
+
+/**
+ * @brief Tranfers the peci packet and get the response.
+ *
+ * Single attempt, retries are scheduled on completion.
+ *
+ * @param *session session opened for the peci target.
+ * @param *msg peci packet message.
+ * @retval 0 on success and failure code on error.
+ */
+static int peci_exec_transfer(struct peci_session *session,
+			      struct peci_msg *msg)
+{
+	int ret;
+	uint8_t rd_len = msg->rx_buffer.len;
+
+	ret = peci_session_transfer(session, msg);
+
+	for (int i = 0; i < rd_len; i++) {
+		LOG_DBG("%s:Rx[%d]-%02x", __func__, i,
+				msg->rx_buffer.buf[i]);
+	}
+
+	LOG_DBG("Peci command = %x success", msg->cmd_code);
+	return ret;
+}
+
+int peci_submit(struct peci_req *req)
+{
+	k_spinlock_key_t key;
+
+	if (!req->msg || !req->done || req->prio >= PECI_PRIO_COUNT) {
+		return -EINVAL;
+	}
+
+	req->tries = 0;
+
+	key = k_spin_lock(&sched.lock);
+	sys_slist_append(&sched.queue[req->prio], &req->node);
+	k_spin_unlock(&sched.lock, key);
+
+	k_sem_give(&peci_sched_sem);
+
+	return 0;
+}
+
+/* Target can't be reached, failure is not the target's fault */
+static bool peci_unavailable(int ret)
+{
+	return ret == -ENODEV || ret == -EHOSTDOWN || ret == -EHOSTUNREACH;
+}
+
+/* Target could not serve the request in time, unlike an illegal request
+ * which is the requester's fault and fails again if retried.
+ */
+static bool peci_cc_transient(uint8_t peci_resp)
+{
+	return peci_resp == PECI_CC_RSP_TIMEOUT ||
+	       peci_resp == PECI_CC_OUT_OF_RESOURCES_TIMEOUT ||
+	       peci_resp == PECI_CC_RESOURCES_LOWPWR_TIMEOUT;
+}
+
+static enum peci_cc_stat peci_cc_stat_of(uint8_t peci_resp)
+{
+	switch (peci_resp) {
+	case PECI_CC_RSP_SUCCESS:
+		return PECI_CC_STAT_SUCCESS;
+	case PECI_CC_RSP_TIMEOUT:
+		return PECI_CC_STAT_TIMEOUT;
+	case PECI_CC_OUT_OF_RESOURCES_TIMEOUT:
+		return PECI_CC_STAT_OUT_OF_RESOURCES;
+	case PECI_CC_RESOURCES_LOWPWR_TIMEOUT:
+		return PECI_CC_STAT_LOW_POWER;
+	case PECI_CC_ILLEGAL_REQUEST:
+		return PECI_CC_STAT_ILLEGAL;
+	default:
+		return PECI_CC_STAT_OTHER;
+	}
+}
+
+/* Must be called with sched lock held */
+static void peci_health_count(struct peci_health *hp, int ret,
+			      uint8_t peci_resp)
+{
+	if (!hp) {
+		return;
+	}
+
+	switch (ret) {
+	case 0:
+		hp->stats.cc[peci_cc_stat_of(peci_resp)]++;
+		break;
+	case -EHOSTDOWN:
+	case -ENODEV:
+		hp->stats.gated++;
+		break;
+	case -EHOSTUNREACH:
+		hp->stats.rejected++;
+		break;
+	default:
+		hp->stats.xfer_errors++;
+		break;
+	}
+}
+
+/* Must be called with sched lock held, returns true if the target had
+ * been paused.
+ */
+static bool peci_health_success(struct peci_health *hp)
+{
+	bool recovered;
+
+	if (!hp) {
+		return false;
+	}
+
+	recovered = hp->failures >= CONFIG_PECI_BREAKER_THRESHOLD;
+	hp->failures = 0;
+	hp->open_until = 0;
+
+	return recovered;
+}
+
+/* Must be called with sched lock held. Once the target failed
+ * PECI_BREAKER_THRESHOLD requests in a row, its requests are rejected for
+ * a pause doubled each time the next request fails as well. Returns the
+ * pause in ms, 0 if the target is not paused.
+ */
+static uint32_t peci_health_failure(struct peci_health *hp)
+{
+	uint32_t pause_ms;
+
+	if (!hp) {
+		return 0;
+	}
+
+	if (hp->failures < UINT8_MAX) {
+		hp->failures++;
+	}
+
+	if (hp->failures < CONFIG_PECI_BREAKER_THRESHOLD) {
+		return 0;
+	}
+
+	pause_ms = CONFIG_PECI_BREAKER_PAUSE_MS <<
+		   MIN(hp->failures - CONFIG_PECI_BREAKER_THRESHOLD,
+		       PECI_BREAKER_PAUSE_SHIFT_MAX);
+	hp->open_until = k_uptime_get() + pause_ms;
+	hp->stats.breaker_trips++;
+
+	return pause_ms;
+}
+
+static void peci_wake_done(struct peci_req *req)
+{
+	struct peci_health *hp = req->user_data;
+	k_spinlock_key_t key = k_spin_lock(&sched.lock);
+
+	hp->wake_busy = false;
+	if (!req->ret) {
+		hp->wake_on_peci =
+			hp->wake_buf[TX_BUF_START_OFFSET + PECI_TX_BUF_DATA0];
+	}
+	k_spin_unlock(&sched.lock, key);
+
+	LOG_DBG("Wake on PECI %x: %d (%d)", hp->addr, hp->wake_on_peci,
+		req->ret);
+}
+
+/* Must be called with sched lock held. Queues the WrPkgConfig setting
+ * wake on PECI ahead of any other request, returns true if queued.
+ */
+static bool peci_wake_on_peci(struct peci_health *hp, bool enable)
+{
+	uint8_t *buf;
+	uint8_t *tx;
+
+	if (!hp || hp->wake_busy || hp->wake_on_peci == enable) {
+		return false;
+	}
+
+	buf = hp->wake_buf;
+	tx = &buf[TX_BUF_START_OFFSET];
+	memsets(buf, 0, sizeof(hp->wake_buf));
+	buf[CLIENT_ADDRESS_OFFSET] = hp->addr;
+	buf[TX_BUF_LEN_OFFSET] = PECI_WR_PKG_LEN_DWORD;
+	buf[RX_BUF_LEN_OFFSET] = PECI_WR_PKG_RD_LEN;
+	buf[COMMAND_CODE_OFFSET] = PECI_CMD_WR_PKG_CFG0;
+	tx[PECI_TX_BUF_INDEX] = PECI_CONFIGINDEX_WAKE_ON_PECI;
+	tx[PECI_TX_BUF_PARAM_LSB] = PECI_WAKE_ON_PECI_PARAM;
+	tx[PECI_TX_BUF_DATA0] = enable;
+	tx[PECI_CFG_WRPKG_AWFCS] = peci_calc_awfcs(buf, PECI_WRPKG_AWFCS_LEN);
+
+	hp->wake_msg.addr = hp->addr;
+	hp->wake_msg.cmd_code = PECI_CMD_WR_PKG_CFG0;
+	hp->wake_msg.tx_buffer.buf = tx;
+	hp->wake_msg.tx_buffer.len = PECI_WR_PKG_LEN_DWORD;
+	hp->wake_msg.rx_buffer.buf = hp->wake_resp;
+	hp->wake_msg.rx_buffer.len = PECI_WR_PKG_RD_LEN;
+
+	hp->wake_req.msg = &hp->wake_msg;
+	hp->wake_req.prio = PECI_PRIO_CRITICAL;
+	hp->wake_req.retry = true;
+	hp->wake_req.done = peci_wake_done;
+	hp->wake_req.user_data = hp;
+	hp->wake_req.tries = 0;
+	hp->wake_busy = true;
+
+	sys_slist_prepend(&sched.queue[PECI_PRIO_CRITICAL], &hp->wake_req.node);
+
+	return true;
+}
+
+/* Must be called with sched lock held. Retries wait PECI_RETRY_WAIT
+ * doubled on each attempt up to PECI_RETRY_WAIT_MAX_MS, plus a jitter of
+ * up to half of it so requests failing together are not retried at once.
+ */
+static void peci_backoff(struct peci_req *req)
+{
+	uint32_t wait = MIN(PECI_RETRY_WAIT << (req->tries - 1),
+			    CONFIG_PECI_RETRY_WAIT_MAX_MS);
+
+	/* Cycle counter is random enough to spread retries */
+	wait += k_cycle_get_32() % (wait / 2 + 1);
+	req->not_before = k_uptime_get() + wait;
+	sys_slist_append(&sched.delayed, &req->node);
+}
+
+/* Must be called with sched lock held. Moves the retries whose backoff
+ * elapsed ahead of their priority queue, returns the time until the next
+ * one is due.
+ */
+static k_timeout_t peci_backoff_expire(void)
+{
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+	sys_snode_t *prev = NULL;
+	struct peci_req *req, *tmp;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&sched.delayed, req, tmp, node) {
+		if (req->not_before <= now) {
+			sys_slist_remove(&sched.delayed, prev, &req->node);
+			sys_slist_prepend(&sched.queue[req->prio], &req->node);
+		} else {
+			next = MIN(next, req->not_before);
+			prev = &req->node;
+		}
+	}
+
+	return next == INT64_MAX ? K_FOREVER : K_MSEC(next - now);
+}
+
+/* Must be called with sched lock held, returns true if the request is
+ * scheduled to be sent again.
+ */
+static bool peci_req_retry(struct peci_health *hp, struct peci_req *req,
+			   uint8_t peci_resp)
+{
+	/* A failing target gets a single attempt until it answers again */
+	uint8_t tries = (hp && hp->failures) ? 1 : PECI_RETRY_CNT;
+
+	if (!req->retry || peci_unavailable(req->ret) ||
+	    (!req->ret && !peci_cc_transient(peci_resp)) ||
+	    ++req->tries >= tries) {
+		return false;
+	}
+
+	if (!req->ret) {
+		peci_resp_retry(req->msg, peci_resp);
+		if (peci_resp == PECI_CC_RESOURCES_LOWPWR_TIMEOUT && hp &&
+		    req != &hp->wake_req) {
+			peci_wake_on_peci(hp, true);
+		}
+	}
+
+	peci_backoff(req);
+
+	return true;
+}
+
+/* Accounts the attempt in the target health, then completes the request or
+ * schedules its retry. Called from the thread the attempt completed in.
+ */
+static void peci_req_complete(struct peci_req *req)
+{
+	struct peci_health *hp = peci_health_of(req->msg->addr);
+	uint8_t peci_resp = PECI_CC_RSP_SUCCESS;
+	bool queued = false;
+	bool recovered = false;
+	uint32_t pause_ms = 0;
+	k_spinlock_key_t key;
+
+	/* Only commands supporting retry return a completion code */
+	if (!req->ret && req->retry) {
+		peci_resp = req->msg->rx_buffer.buf[PECI_RX_BUF_RESP_OFFSET];
+		LOG_DBG("peci_resp %x", peci_resp);
+	}
+
+	key = k_spin_lock(&sched.lock);
+	peci_health_count(hp, req->ret, peci_resp);
+
+	if (!req->ret && peci_resp == PECI_CC_RSP_SUCCESS) {
+		recovered = peci_health_success(hp);
+	} else if (peci_req_retry(hp, req, peci_resp)) {
+		k_spin_unlock(&sched.lock, key);
+		k_sem_give(&peci_sched_sem);
+		return;
+	} else if (!peci_unavailable(req->ret)) {
+		/* Only transfer errors and targets not keeping up count
+		 * against the target health.
+		 */
+		if (req->ret || peci_cc_transient(peci_resp)) {
+			pause_ms = peci_health_failure(hp);
+		}
+
+		if (req->retry) {
+			req->ret = -EIO;
+		}
+	}
+
+	/* Wake on PECI is only kept for the request needing it */
+	if (hp && req != &hp->wake_req) {
+		queued = peci_wake_on_peci(hp, false);
+	}
+	k_spin_unlock(&sched.lock, key);
+
+	if (req->ret == -EIO) {
+		LOG_ERR("Peci command %x failed", req->msg->cmd_code);
+	}
+
+	if (pause_ms) {
+		LOG_WRN("PECI target %x failing, paused for %u ms",
+			req->msg->addr, pause_ms);
+	} else if (recovered) {
+		LOG_INF("PECI target %x recovered", req->msg->addr);
+	}
+
+	if (queued) {
+		k_sem_give(&peci_sched_sem);
+	}
+
+	/* Request may be released by its owner */
+	req->done(req);
+}
+
+int peci_get_health_stats(enum peci_devices dev,
+			  struct peci_health_stats *stats)
+{
+	struct peci_health *hp = peci_health_of(get_peci_address(dev));
+	k_spinlock_key_t key;
+
+	if (!hp) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&sched.lock);
+	*stats = hp->stats;
+	k_spin_unlock(&sched.lock, key);
+
+	return 0;
+}
+
+/* Only one PECI OOB request is outstanding, its completion lets the
+ * scheduler send the next one.
+ */
+static void espioob_peci_done(struct espi_oob_packet *rx, int err)
+{
+	struct peci_req *req;
+	k_spinlock_key_t key = k_spin_lock(&sched.lock);
+
+	req = sched.oob_busy;
+	sched.oob_busy = NULL;
+	k_spin_unlock(&sched.lock, key);
+
+	if (!req) {
+		LOG_WRN("Unexpected PECI OOB response");
+		return;
+	}
+
+	if (err) {
+		LOG_ERR("PECI OOB Txn failed %d", err);
+		req->ret = err;
+	} else {
+		req->ret = espioob_peci_resp_copy(req->msg,
+				(struct espi_oob_peci_resp_msg *)rx->buf);
+	}
+
+	peci_req_complete(req);
+	k_sem_give(&peci_sched_sem);
+}
+
+/* Sends the request without waiting for the PCH response */
+static void espioob_peci_submit(struct peci_req *req)
+{
+	struct espi_oob_peci_req_msg oob_req;
+	struct espi_oob_packet req_pckt;
+	k_spinlock_key_t key;
+	int ret;
+
+	req_pckt.buf = (uint8_t *)&oob_req;
+	req_pckt.len = espioob_peci_req_init(&oob_req, req->msg);
+
+	key = k_spin_lock(&sched.lock);
+	sched.oob_busy = req;
+	k_spin_unlock(&sched.lock, key);
+
+	ret = oob_send_async(&req_pckt, espioob_peci_done);
+	if (!ret) {
+		return;
+	}
+
+	key = k_spin_lock(&sched.lock);
+	sched.oob_busy = NULL;
+	if (ret == -ENOBUFS) {
+		/* OOB manager is busy with other requests, not the target's
+		 * fault, send it again once some room is made.
+		 */
+		req->not_before = k_uptime_get() + PECI_RETRY_WAIT;
+		sys_slist_append(&sched.delayed, &req->node);
+		k_spin_unlock(&sched.lock, key);
+		LOG_DBG("PECI OOB queue full");
+		return;
+	}
+	k_spin_unlock(&sched.lock, key);
+
+	LOG_ERR("PECI OOB Txn failed %d", ret);
+	req->ret = ret;
+	peci_req_complete(req);
+}
+
+/* Highest priority request. When a session is given, the request is only
+ * taken if it is for the same target, so a higher priority request for
+ * another target ends the session. PECI over eSPI requests wait while
+ * another one is outstanding, requests for legacy PECI targets queued
+ * behind them at the same priority are served meanwhile.
+ */
+static struct peci_req *peci_sched_next(const struct peci_session *session)
+{
+	struct peci_req *req = NULL;
+	k_spinlock_key_t key = k_spin_lock(&sched.lock);
+
+	peci_backoff_expire();
+
+	for (int prio = 0; prio < PECI_PRIO_COUNT && !req; prio++) {
+		sys_snode_t *prev = NULL;
+		struct peci_req *it;
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&sched.queue[prio], it, node) {
+			if (!sched.oob_busy || !peci_over_oob(it->msg->addr)) {
+				req = it;
+				break;
+			}
+			prev = &it->node;
+		}
+
+		if (!req) {
+			continue;
+		}
+
+		if (session && req->msg->addr != session->addr) {
+			req = NULL;
+			break;
+		}
+
+		sys_slist_remove(&sched.queue[prio], prev, &req->node);
+	}
+
+	k_spin_unlock(&sched.lock, key);
+
+	return req;
+}
+
+static void peci_sched_exec(struct peci_session *session,
+			    struct peci_req *req)
+{
+	int status = session->status;
+
+	/* Target kept failing, give it time to recover. Critical requests
+	 * are never rejected, they probe the target instead.
+	 */
+	if (!status && session->paused && req->prio != PECI_PRIO_CRITICAL) {
+		LOG_DBG("Skip peci to paused %x", session->addr);
+		status = -EHOSTUNREACH;
+	}
+
+	if (status) {
+		req->ret = status;
+		peci_req_complete(req);
+		return;
+	}
+
+	/* PECI over eSPI requests complete in the OOB manager thread */
+	if (session->oob) {
+		espioob_peci_submit(req);
+		return;
+	}
+
+	req->ret = peci_exec_transfer(session, req->msg);
+	peci_req_complete(req);
+}
+
+void peci_sched_thread(void *p1, void *p2, void *p3)
+{
+	struct peci_session session;
+	struct peci_req *req;
+	k_spinlock_key_t key;
+	k_timeout_t timeout;
+	int count;
+
+	sched.tid = k_current_get();
+
+	while (true) {
+		key = k_spin_lock(&sched.lock);
+		timeout = peci_backoff_expire();
+		k_spin_unlock(&sched.lock, key);
+
+		k_sem_take(&peci_sched_sem, timeout);
+
+		while ((req = peci_sched_next(NULL)) != NULL) {
+			peci_session_open(&session, req->msg->addr);
+			count = 0;
+
+			do {
+				peci_sched_exec(&session, req);
+			} while (++count < CONFIG_PECI_SCHED_BATCH_MAX &&
+				 (req = peci_sched_next(&session)) != NULL);
+		}
+	}
+}
+
+#ifdef CONFIG_PECI_CACHE
+/* RdPkgConfig index and parameter, following the host id */
+#define PECI_CACHE_KEY_LEN	3U
+#define PECI_CACHE_DATA_LEN	8U
+
+/* Read result, keyed by target, command, index/parameter and length */
+struct peci_cache_entry {
+	/* Uptime in ms the entry expires at, 0 if valid until reset */
+	int64_t expiry;
+	uint8_t addr;
+	uint8_t cmd_code;
+	uint8_t key[PECI_CACHE_KEY_LEN];
+	uint8_t len;
+	uint8_t data[PECI_CACHE_DATA_LEN];
+	bool valid;
+};
+
+static struct {
+	struct peci_cache_entry entries[CONFIG_PECI_CACHE_ENTRIES];
+	struct k_spinlock lock;
+	/* Next entry replaced when none is free */
+	uint8_t victim;
+	uint32_t hits;
+	uint32_t misses;
+} cache;
+
+/* Time to live in ms of a RdPkgConfig result. Only indexes known to
+ * change slowly are cached, counters like package energy would be served
+ * stale. Returns -ENOTSUP if the index is not cached.
+ */
+static int peci_cache_pkg_ttl(uint8_t index)
+{
+	switch (index) {
+	case PECI_CONFIGINDEX_PKG_ID:
+	case PECI_CONFIGINDEX_TJMAX:
+		return CONFIG_PECI_CACHE_STATIC_TTL_MS;
+	case PECI_CONFIGINDEX_PWR_SKU_LOW:
+	case PECI_CONFIGINDEX_PWR_SKU_HIGH:
+	case PECI_CONFIGINDEX_PWR_SKU_UNIT:
+		return CONFIG_PECI_CACHE_PKG_TTL_MS;
+	default:
+		return -ENOTSUP;
+	}
+}
+
+/* Time to live in ms of the command result, 0 if it is valid until
+ * platform reset. Returns -ENOTSUP if the result is not cached.
+ */
+static int peci_cache_ttl(struct peci_msg *msg)
+{
+	uint8_t index;
+
+	if (msg->rx_buffer.len > PECI_CACHE_DATA_LEN) {
+		return -ENOTSUP;
+	}
+
+	switch (msg->cmd_code) {
+	case PECI_CMD_GET_DIB:
+		return CONFIG_PECI_CACHE_STATIC_TTL_MS;
+	case PECI_CMD_RD_PKG_CFG0:
+		if (msg->tx_buffer.len < PECI_RD_PKG_WR_LEN) {
+			return -ENOTSUP;
+		}
+
+		index = msg->tx_buffer.buf[PECI_TX_BUF_INDEX];
+		return peci_cache_pkg_ttl(index);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+static void peci_cache_key(struct peci_msg *msg, uint8_t *key)
+{
+	memsets(key, 0, PECI_CACHE_KEY_LEN);
+	if (msg->cmd_code == PECI_CMD_RD_PKG_CFG0) {
+		memcpys(key, &msg->tx_buffer.buf[PECI_TX_BUF_INDEX],
+			PECI_CACHE_KEY_LEN);
+	}
+}
+
+/* Must be called with cache lock held */
+static struct peci_cache_entry *peci_cache_find(struct peci_msg *msg,
+						const uint8_t *key)
+{
+	struct peci_cache_entry *entry;
+
+	for (int i = 0; i < ARRAY_SIZE(cache.entries); i++) {
+		entry = &cache.entries[i];
+		if (entry->valid && entry->addr == msg->addr &&
+		    entry->cmd_code == msg->cmd_code &&
+		    entry->len == msg->rx_buffer.len &&
+		    !memcmp(entry->key, key, PECI_CACHE_KEY_LEN)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Fills the response from the cache, returns true on hit */
+static bool peci_cache_get(struct peci_msg *msg)
+{
+	struct peci_cache_entry *entry;
+	uint8_t key[PECI_CACHE_KEY_LEN];
+	k_spinlock_key_t lock;
+
+	if (peci_cache_ttl(msg) < 0) {
+		return false;
+	}
+
+	peci_cache_key(msg, key);
 
-	ret = oob_send_sync(&req_pckt, &resp_pckt, OOB_MSG_SYNC_WAIT_TIME_DFLT);
-	if (ret) {
-		LOG_ERR("PECI OOB Txn failed %d", ret);
-		return ret;
+	lock = k_spin_lock(&cache.lock);
+	entry = peci_cache_find(msg, key);
+	if (entry && entry->expiry && entry->expiry <= k_uptime_get()) {
+		entry->valid = false;
+		entry = NULL;
 	}
 
-	/* Response length include peci command code and response code.
-	 * So exclude 2 byte for data.
-	 */
-	if (oob_resp.oob_byte_cnt > 2) {
-		ret = memcpys(msg->rx_buffer.buf, oob_resp.data,
-					oob_resp.oob_byte_cnt - 2);
-		if (ret) {
-			LOG_ERR("Failed while copying response buffer");
-			return ret;
-		}
+	if (entry) {
+		memcpys(msg->rx_buffer.buf, entry->data, entry->len);
+		cache.hits++;
 	}
+	k_spin_unlock(&cache.lock, lock);
 
-	return 0;
+	return entry != NULL;
 }
 
-/**
- * @brief Tranfers the peci packet and get the response.
- *
- * This function is intended for peci commands which
- * doenst support command retry.
- *
- * @param *msg peci packet message.
- * @retval 0 on success and failure code on error.
+/* Stores a successful read, counted as a miss since it was not served from
+ * the cache. A write drops the results of its target.
  */
-static int peci_exec_transfer(struct peci_msg *msg)
+static void peci_cache_update(struct peci_msg *msg)
 {
-	int ret;
-	uint8_t rd_len = msg->rx_buffer.len;
+	struct peci_cache_entry *entry = NULL;
+	uint8_t key[PECI_CACHE_KEY_LEN];
+	k_spinlock_key_t lock;
+	int ttl = peci_cache_ttl(msg);
 
-	k_mutex_lock(&trans_mutex, K_FOREVER);
-	if (!peci_initialized && !is_peci_over_espi_en()) {
-		LOG_ERR("PECI not initialized");
-		k_mutex_unlock(&trans_mutex);
-		return -ENODEV;
+	switch (msg->cmd_code) {
+	case PECI_CMD_WR_PKG_CFG0:
+	case PECI_CMD_WR_IAMSR0:
+	case PECI_CMD_WR_PCI_CFG0:
+		lock = k_spin_lock(&cache.lock);
+		for (int i = 0; i < ARRAY_SIZE(cache.entries); i++) {
+			if (cache.entries[i].addr == msg->addr) {
+				cache.entries[i].valid = false;
+			}
+		}
+		k_spin_unlock(&cache.lock, lock);
+		return;
+	default:
+		break;
 	}
 
-	/* PECI over eSPI is supported only for CPU. For
-	 * others (like GPU), only legacy PECI is supported
-	 */
-	if (is_peci_over_espi_en() && (msg->addr == PECI_CPU_ADDR)) {
-		ret = espioob_peci_transfer(msg);
-	} else {
-		ret = peci_wire_transfer(peci_dev, msg);
+	if (ttl < 0) {
+		return;
 	}
 
-	for (int i = 0; i < rd_len; i++) {
-		LOG_DBG("%s:Rx[%d]-%02x", __func__, i,
-				msg->rx_buffer.buf[i]);
+	peci_cache_key(msg, key);
+
+	lock = k_spin_lock(&cache.lock);
+	entry = peci_cache_find(msg, key);
+	for (int i = 0; !entry && i < ARRAY_SIZE(cache.entries); i++) {
+		if (!cache.entries[i].valid) {
+			entry = &cache.entries[i];
+		}
 	}
 
-	LOG_DBG("Peci command = %x success", msg->cmd_code);
-	k_mutex_unlock(&trans_mutex);
-	return ret;
+	if (!entry) {
+		entry = &cache.entries[cache.victim];
+		cache.victim = (cache.victim + 1) % ARRAY_SIZE(cache.entries);
+	}
+
+	entry->expiry = ttl ? k_uptime_get() + ttl : 0;
+	entry->addr = msg->addr;
+	entry->cmd_code = msg->cmd_code;
+	entry->len = msg->rx_buffer.len;
+	memcpys(entry->key, key, PECI_CACHE_KEY_LEN);
+	memcpys(entry->data, msg->rx_buffer.buf, entry->len);
+	entry->valid = true;
+	cache.misses++;
+	k_spin_unlock(&cache.lock, lock);
+}
+#else
+static inline bool peci_cache_get(struct peci_msg *msg)
+{
+	return false;
 }
 
-/**
- * @brief Tranfers the peci packet with retry and get the response.
- *
- * This function is intended for peci commands
- * supports command retry.
- *
- * @param *msg peci packet message.
- * @retval 0 on success and failure code on error.
- */
-static int peci_exec_transfer_retry(struct peci_msg *msg)
+static inline void peci_cache_update(struct peci_msg *msg)
 {
-	int ret;
-	int retries = PECI_RETRY_CNT;
-	uint8_t peci_resp = 0;
+}
+#endif /* CONFIG_PECI_CACHE */
 
-	k_mutex_lock(&trans_mutex, K_FOREVER);
-	if (!peci_initialized && !is_peci_over_espi_en()) {
-		LOG_ERR("PECI not initialized");
-		k_mutex_unlock(&trans_mutex);
-		return -ENODEV;
+void peci_cache_invalidate(void)
+{
+#ifdef CONFIG_PECI_CACHE
+	k_spinlock_key_t lock = k_spin_lock(&cache.lock);
+
+	for (int i = 0; i < ARRAY_SIZE(cache.entries); i++) {
+		cache.entries[i].valid = false;
 	}
+	k_spin_unlock(&cache.lock, lock);
+#endif
 
-	do {
-		retries--;
+	/* TjMax is read again as well */
+	cpu_tjmax = 0;
+	gpu_tjmax = 0;
+}
 
-		/* PECI over eSPI is supported only for CPU. For
-		 * others (like GPU), only legacy PECI is supported
-		 */
-		if (is_peci_over_espi_en() && (msg->addr == PECI_CPU_ADDR)) {
-			ret = espioob_peci_transfer(msg);
-		} else {
-			ret = peci_wire_transfer(peci_dev, msg);
-		}
-		if (ret) {
-			continue;
-		}
+void peci_get_cache_stats(struct peci_cache_stats *stats)
+{
+#ifdef CONFIG_PECI_CACHE
+	k_spinlock_key_t lock = k_spin_lock(&cache.lock);
 
-		peci_resp = msg->rx_buffer.buf[PECI_RX_BUF_RESP_OFFSET];
-		LOG_DBG("peci_resp %x", peci_resp);
+	stats->hits = cache.hits;
+	stats->misses = cache.misses;
+	k_spin_unlock(&cache.lock, lock);
+#else
+	stats->hits = 0;
+	stats->misses = 0;
+#endif
+}
 
-		if (peci_resp == PECI_CC_RSP_SUCCESS) {
-			/* Command execution successful */
-			break;
-		}
+static void peci_sync_done(struct peci_req *req)
+{
+	k_sem_give(req->user_data);
+}
 
-		/* Command failed! Verify response code */
-		switch (peci_resp) {
-		case PECI_CC_RSP_TIMEOUT:
-		case PECI_CC_OUT_OF_RESOURCES_TIMEOUT:
-			/* Retry cmd since processor unable to generate response
-			 * ontime or unable to allocate resources required to
-			 * service the cmd.
-			 */
-			k_msleep(PECI_RETRY_WAIT);
-			msg->tx_buffer.buf[PECI_TX_BUF_HOSTIDRETRY_OFFSET] |=
-						PECI_RETRY_EN;
-			break;
-		case PECI_CC_RESOURCES_LOWPWR_TIMEOUT:
-			/* TODO: Resources required to service cmd are in low
-			 * power mode. Enable "wake on peci" mode to pop-up
-			 * processor to C2 state to service the cmd.
-			 */
-			break;
-		case PECI_CC_ILLEGAL_REQUEST:
-			/* Invalid or illegal Request */
-			break;
-		default:
-			LOG_WRN("Invalid peci response %x", peci_resp);
-			break;
-		}
-	} while (retries > 0);
+/* Queue a request and wait for its completion */
+static int peci_exec(struct peci_msg *msg, bool retry, enum peci_prio prio)
+{
+	struct k_sem done;
+	struct peci_req req = {
+		.msg = msg,
+		.prio = prio,
+		.retry = retry,
+		.done = peci_sync_done,
+		.user_data = &done,
+	};
+	int ret;
 
-	k_mutex_unlock(&trans_mutex);
+	/* Completion callbacks run in the scheduler thread */
+	if (k_current_get() == sched.tid) {
+		LOG_ERR("Nested peci request");
+		return -EDEADLK;
+	}
 
-	if (peci_resp != PECI_CC_RSP_SUCCESS) {
-		LOG_ERR("Peci command %x failed", msg->cmd_code);
-		return -EIO;
+	if (peci_cache_get(msg)) {
+		return 0;
 	}
 
-	LOG_DBG("Peci command=%x success", msg->cmd_code);
-	return 0;
+	k_sem_init(&done, 0, 1);
+	ret = peci_submit(&req);
+	if (ret) {
+		return ret;
+	}
+
+	k_sem_take(&done, K_FOREVER);
+	if (!req.ret) {
+		peci_cache_update(msg);
+	}
+
+	return req.ret;
 }
 
 int peci_cmd_execute(uint8_t *req_buf, uint8_t *resp_buf,
@@ -469,7 +1272,7 @@ int peci_cmd_execute(uint8_t *req_buf, uint8_t *resp_buf,
 	case PECI_CMD_PING:
 	case PECI_CMD_GET_DIB:
 	case PECI_CMD_GET_TEMP0:
-		ret = peci_exec_transfer(&packet);
+		ret = peci_exec(&packet, false, PECI_PRIO_HOST);
 		break;
 	case PECI_CMD_RD_PKG_CFG0:
 	case PECI_CMD_WR_PKG_CFG0:
@@ -477,7 +1280,7 @@ int peci_cmd_execute(uint8_t *req_buf, uint8_t *resp_buf,
 	case PECI_CMD_WR_IAMSR0:
 	case PECI_CMD_RD_PCI_CFG0:
 	case PECI_CMD_WR_PCI_CFG0:
-		ret = peci_exec_transfer_retry(&packet);
+		ret = peci_exec(&packet, true, PECI_PRIO_HOST);
 		break;
 	default:
 		LOG_WRN("Invalid peci command %x", packet.cmd_code);
@@ -564,22 +1367,29 @@ int peci_update_pl4_offset(uint32_t pl4_value)
 	return 0;
 }
 
-int peci_rdpkg_config(enum peci_devices dev, uint8_t *req_buf,
-		      uint8_t *resp_buf, uint8_t rd_len)
+static void peci_rdpkg_msg_init(struct peci_msg *packet, uint8_t address,
+				uint8_t *req_buf, uint8_t *resp_buf,
+				uint8_t rd_len)
+{
+	packet->tx_buffer.buf = req_buf;
+	packet->tx_buffer.len = PECI_RD_PKG_WR_LEN;
+	packet->rx_buffer.buf = resp_buf;
+	packet->rx_buffer.len = rd_len;
+
+	packet->addr = address;
+	packet->cmd_code = PECI_CMD_RD_PKG_CFG0;
+}
+
+static int peci_rdpkg(enum peci_devices dev, uint8_t *req_buf,
+		      uint8_t *resp_buf, uint8_t rd_len, enum peci_prio prio)
 {
 	int ret;
 	struct peci_msg packet;
-	uint8_t address = get_peci_address(dev);
 
-	packet.tx_buffer.buf = req_buf;
-	packet.tx_buffer.len = PECI_RD_PKG_WR_LEN;
-	packet.rx_buffer.buf = resp_buf;
-	packet.rx_buffer.len = rd_len;
-
-	packet.addr = address;
-	packet.cmd_code = PECI_CMD_RD_PKG_CFG0;
+	peci_rdpkg_msg_init(&packet, get_peci_address(dev), req_buf, resp_buf,
+			    rd_len);
 
-	ret = peci_exec_transfer_retry(&packet);
+	ret = peci_exec(&packet, true, prio);
 	if (ret) {
 		LOG_ERR("Peci RdPkgConfig failed");
 	}
@@ -587,6 +1397,12 @@ int peci_rdpkg_config(enum peci_devices dev, uint8_t *req_buf,
 	return ret;
 }
 
+int peci_rdpkg_config(enum peci_devices dev, uint8_t *req_buf,
+		      uint8_t *resp_buf, uint8_t rd_len)
+{
+	return peci_rdpkg(dev, req_buf, resp_buf, rd_len, PECI_PRIO_HOST);
+}
+
 int peci_wrpkg_config(uint8_t *req_buf, uint8_t *resp_buf, uint8_t wr_len)
 {
 	int ret;
@@ -601,7 +1417,7 @@ int peci_wrpkg_config(uint8_t *req_buf, uint8_t *resp_buf, uint8_t wr_len)
 	packet.tx_buffer.buf[PECI_CFG_WRPKG_AWFCS] =
 				peci_calc_awfcs(req_buf, PECI_WRPKG_AWFCS_LEN);
 
-	ret = peci_exec_transfer_retry(&packet);
+	ret = peci_exec(&packet, true, PECI_PRIO_HOST);
 	if (ret) {
 		LOG_ERR("Peci WrPkgConfig failed (0x%x)", ret);
 	}
@@ -624,7 +1440,7 @@ int peci_rd_ia_msr(enum peci_devices dev, uint8_t *req_buf,
 	packet.addr = address;
 	packet.cmd_code = PECI_CMD_RD_IAMSR0;
 
-	ret = peci_exec_transfer_retry(&packet);
+	ret = peci_exec(&packet, true, PECI_PRIO_HOST);
 	if (ret) {
 		LOG_ERR("Peci RdIAMSR failed");
 	}
@@ -649,7 +1465,7 @@ int peci_wr_ia_msr(enum peci_devices dev, uint8_t *req_buf,
 	packet.addr = address;
 	packet.cmd_code = PECI_CMD_WR_IAMSR0;
 
-	ret = peci_exec_transfer_retry(&packet);
+	ret = peci_exec(&packet, true, PECI_PRIO_HOST);
 	if (ret) {
 		LOG_ERR("Peci WrIAMSR failed");
 	}
@@ -673,30 +1489,37 @@ int peci_get_dib(enum peci_devices dev, uint8_t *dev_info, uint8_t *rev_num)
 	packet.addr = address;
 	packet.cmd_code = PECI_CMD_GET_DIB;
 
-	ret = peci_exec_transfer(&packet);
+	ret = peci_exec(&packet, false, PECI_PRIO_HOST);
 	if (ret) {
 		LOG_ERR("Peci GetDIB failed");
 	} else {
 		*dev_info = resp_buf[PECI_GET_DIB_DEVINFO];
-		*rev_num = resp_buf[PECI_GET_DIB_RD_LEN];
+		*rev_num = resp_buf[PECI_GET_DIB_REVNUM];
 	}
 
 	return ret;
 }
 
 
+static const uint8_t peci_tjmax_req[] = {
+	PECI_CONFIGHOSTID,
+	PECI_CONFIGINDEX_TJMAX,
+	PECI_CONFIGPARAM & 0x00FF,
+	(PECI_CONFIGPARAM & 0xFF00) >> 8,
+};
+
 int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax)
 {
 	int ret;
 
 	uint8_t resp_buf[PECI_RD_PKG_LEN_DWORD + PECI_FCS_LEN];
-	uint8_t req_buf[] = { PECI_CONFIGHOSTID,
-				PECI_CONFIGINDEX_TJMAX,
-				PECI_CONFIGPARAM & 0x00FF,
-				(PECI_CONFIGPARAM & 0xFF00) >> 8,
-	};
+	uint8_t req_buf[sizeof(peci_tjmax_req)];
+
+	memcpys(req_buf, peci_tjmax_req, sizeof(req_buf));
 
-	ret = peci_rdpkg_config(dev, req_buf, resp_buf, PECI_RD_PKG_LEN_DWORD);
+	/* Temperature can't be computed without TjMax */
+	ret = peci_rdpkg(dev, req_buf, resp_buf, PECI_RD_PKG_LEN_DWORD,
+			 PECI_PRIO_CRITICAL);
 
 	if (!ret) {
 		*tjmax = resp_buf[PECI_RX_BUF_TJMAX_OFFSET];
@@ -706,59 +1529,38 @@ int peci_get_tjmax(enum peci_devices dev, uint8_t *tjmax)
 	return ret;
 }
 
-int peci_get_temp(enum peci_devices dev, int *temperature)
+static uint8_t *peci_tjmax_of(enum peci_devices dev)
 {
-	uint16_t raw_cpu_temp;
-	uint16_t peci_resp;
-	int ret;
-	struct peci_msg packet;
-	uint8_t tjmax;
-	uint8_t *tjmax_ptr;
-	uint8_t address = get_peci_address(dev);
-
 	switch (dev) {
 	case CPU:
-		tjmax_ptr = &cpu_tjmax;
-		break;
+		return &cpu_tjmax;
 
 	case GPU:
-		tjmax_ptr = &gpu_tjmax;
-		break;
+		return &gpu_tjmax;
 
 	default:
 		LOG_ERR("Unknown PECI device: %d", dev);
-		return -EINVAL;
-	}
-
-	/* If cpu/gpu tjmax is not fetched then cpu/gpu temperature cannot
-	 * be calculated. In this case return fail safe temperature.
-	 */
-	if (*tjmax_ptr == 0) {
-		ret = peci_get_tjmax(dev, tjmax_ptr);
-		if (ret) {
-			LOG_ERR("Fail to get CPU/GPU TjMax: %d", ret);
-			*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
-			return -EINVAL;
-		}
+		return NULL;
 	}
-	tjmax = *tjmax_ptr;
-
-	uint8_t resp_buf[PECI_GET_TEMP_RD_LEN + PECI_FCS_LEN];
+}
 
-	packet.tx_buffer.buf = NULL;
-	packet.tx_buffer.len = PECI_GET_TEMP_WR_LEN;
-	packet.rx_buffer.buf = resp_buf;
-	packet.rx_buffer.len = PECI_GET_TEMP_RD_LEN;
+static void peci_get_temp_msg_init(struct peci_msg *packet, uint8_t address,
+				   uint8_t *resp_buf)
+{
+	packet->tx_buffer.buf = NULL;
+	packet->tx_buffer.len = PECI_GET_TEMP_WR_LEN;
+	packet->rx_buffer.buf = resp_buf;
+	packet->rx_buffer.len = PECI_GET_TEMP_RD_LEN;
 
-	packet.addr = address;
-	packet.cmd_code = PECI_CMD_GET_TEMP0;
+	packet->addr = address;
+	packet->cmd_code = PECI_CMD_GET_TEMP0;
+}
 
-	ret = peci_exec_transfer(&packet);
-	if (ret) {
-		LOG_ERR("Peci GetTemp failed, ret-%d", ret);
-		*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
-		return ret;
-	}
+static int peci_temp_from_resp(uint8_t tjmax, uint8_t *resp_buf,
+			       int *temperature)
+{
+	uint16_t raw_cpu_temp;
+	uint16_t peci_resp;
 
 	peci_resp = (uint16_t)(resp_buf[PECI_GET_TEMP_LSB] |
 		    (uint16_t)((resp_buf[PECI_GET_TEMP_MSB] << 8) & 0xFF00));
@@ -804,6 +1606,169 @@ int peci_get_temp(enum peci_devices dev, int *temperature)
 	return 0;
 }
 
+int peci_get_temp(enum peci_devices dev, int *temperature)
+{
+	int ret;
+	struct peci_msg packet;
+	uint8_t *tjmax_ptr = peci_tjmax_of(dev);
+
+	if (!tjmax_ptr) {
+		return -EINVAL;
+	}
+
+	/* If cpu/gpu tjmax is not fetched then cpu/gpu temperature cannot
+	 * be calculated. In this case return fail safe temperature.
+	 */
+	if (*tjmax_ptr == 0) {
+		ret = peci_get_tjmax(dev, tjmax_ptr);
+		if (ret) {
+			LOG_ERR("Fail to get CPU/GPU TjMax: %d", ret);
+			*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
+			return -EINVAL;
+		}
+	}
+
+	uint8_t resp_buf[PECI_GET_TEMP_RD_LEN + PECI_FCS_LEN];
+
+	peci_get_temp_msg_init(&packet, get_peci_address(dev), resp_buf);
+
+	ret = peci_exec(&packet, false, PECI_PRIO_CRITICAL);
+	if (ret) {
+		LOG_ERR("Peci GetTemp failed, ret-%d", ret);
+		*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
+		return ret;
+	}
+
+	return peci_temp_from_resp(*tjmax_ptr, resp_buf, temperature);
+}
+
+enum peci_temp_state {
+	PECI_TEMP_IDLE,
+	PECI_TEMP_PENDING,
+	PECI_TEMP_DONE,
+	/* Result is discarded once the request completes */
+	PECI_TEMP_CANCELLED,
+};
+
+/* Temperature read started on behalf of the thermal loop, collected on
+ * its next tick so a slow PCH doesn't hold it.
+ */
+struct peci_temp_read {
+	struct peci_req req;
+	struct peci_msg msg;
+	uint8_t req_buf[sizeof(peci_tjmax_req)];
+	uint8_t resp_buf[MAX(PECI_RD_PKG_LEN_DWORD, PECI_GET_TEMP_RD_LEN) +
+			 PECI_FCS_LEN];
+	/* TjMax is read instead of the temperature */
+	bool tjmax;
+	atomic_t state;
+};
+
+static struct peci_temp_read temp_reads[GPU + 1];
+
+static void peci_temp_read_done(struct peci_req *req)
+{
+	struct peci_temp_read *rd = CONTAINER_OF(req, struct peci_temp_read,
+						 req);
+
+	if (!atomic_cas(&rd->state, PECI_TEMP_CANCELLED, PECI_TEMP_IDLE)) {
+		atomic_set(&rd->state, PECI_TEMP_DONE);
+	}
+}
+
+int peci_get_temp_async(enum peci_devices dev)
+{
+	struct peci_temp_read *rd;
+	uint8_t *tjmax_ptr = peci_tjmax_of(dev);
+	uint8_t address;
+	int ret;
+
+	if (!tjmax_ptr) {
+		return -EINVAL;
+	}
+
+	rd = &temp_reads[dev];
+	if (!atomic_cas(&rd->state, PECI_TEMP_IDLE, PECI_TEMP_PENDING)) {
+		return -EBUSY;
+	}
+
+	address = get_peci_address(dev);
+	rd->tjmax = !*tjmax_ptr;
+	if (rd->tjmax) {
+		memcpys(rd->req_buf, peci_tjmax_req, sizeof(rd->req_buf));
+		peci_rdpkg_msg_init(&rd->msg, address, rd->req_buf,
+				    rd->resp_buf, PECI_RD_PKG_LEN_DWORD);
+	} else {
+		peci_get_temp_msg_init(&rd->msg, address, rd->resp_buf);
+	}
+
+	rd->req.msg = &rd->msg;
+	rd->req.prio = PECI_PRIO_CRITICAL;
+	rd->req.retry = rd->tjmax;
+	rd->req.done = peci_temp_read_done;
+
+	ret = peci_submit(&rd->req);
+	if (ret) {
+		atomic_set(&rd->state, PECI_TEMP_IDLE);
+	}
+
+	return ret;
+}
+
+int peci_get_temp_result(enum peci_devices dev, int *temperature)
+{
+	struct peci_temp_read *rd;
+	uint8_t *tjmax_ptr = peci_tjmax_of(dev);
+	int ret;
+
+	if (!tjmax_ptr) {
+		return -EINVAL;
+	}
+
+	rd = &temp_reads[dev];
+	switch (atomic_get(&rd->state)) {
+	case PECI_TEMP_IDLE:
+		return -ENODATA;
+	case PECI_TEMP_PENDING:
+	case PECI_TEMP_CANCELLED:
+		return -EINPROGRESS;
+	default:
+		break;
+	}
+
+	ret = rd->req.ret;
+	if (ret) {
+		LOG_ERR("Peci %s failed, ret-%d",
+			rd->tjmax ? "TjMax" : "GetTemp", ret);
+		*temperature = PECI_CPUGPU_TEMP_FAILSAFE;
+	} else if (rd->tjmax) {
+		*tjmax_ptr = rd->resp_buf[PECI_RX_BUF_TJMAX_OFFSET];
+		LOG_INF("TjMax=%d", *tjmax_ptr);
+		ret = -EAGAIN;
+	} else {
+		ret = peci_temp_from_resp(*tjmax_ptr, rd->resp_buf,
+					  temperature);
+	}
+
+	atomic_set(&rd->state, PECI_TEMP_IDLE);
+
+	return ret;
+}
+
+void peci_get_temp_cancel(enum peci_devices dev)
+{
+	struct peci_temp_read *rd;
+
+	if (!peci_tjmax_of(dev)) {
+		return;
+	}
+
+	rd = &temp_reads[dev];
+	if (!atomic_cas(&rd->state, PECI_TEMP_PENDING, PECI_TEMP_CANCELLED)) {
+		atomic_cas(&rd->state, PECI_TEMP_DONE, PECI_TEMP_IDLE);
+	}
+}
+
 int peci_init(void)
 {
 	int ret;
@@ -838,3 +1803,71 @@ int peci_init(void)
 	return 0;
 }
 
+#ifdef CONFIG_SHELL
+#ifdef CONFIG_PECI_CACHE
+static int cmd_cache_show(const struct shell *sh, size_t argc, char **argv)
+{
+	struct peci_cache_stats stats;
+
+	peci_get_cache_stats(&stats);
+	shell_print(sh, "hits %u misses %u", stats.hits, stats.misses);
+
+	return 0;
+}
+
+static int cmd_cache_flush(const struct shell *sh, size_t argc, char **argv)
+{
+	peci_cache_invalidate();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_peci_cache,
+	SHELL_CMD(show, NULL, "Show PECI cache hits and misses",
+		  cmd_cache_show),
+	SHELL_CMD(flush, NULL, "Invalidate PECI cache", cmd_cache_flush),
+	SHELL_SUBCMD_SET_END
+);
+#endif
+
+static void health_print(const struct shell *sh, const char *name,
+			 enum peci_devices dev)
+{
+	struct peci_health_stats stats;
+
+	if (peci_get_health_stats(dev, &stats)) {
+		return;
+	}
+
+	shell_print(sh, "%s: ok %u timeout %u resources %u lowpwr %u "
+		    "illegal %u other %u", name,
+		    stats.cc[PECI_CC_STAT_SUCCESS],
+		    stats.cc[PECI_CC_STAT_TIMEOUT],
+		    stats.cc[PECI_CC_STAT_OUT_OF_RESOURCES],
+		    stats.cc[PECI_CC_STAT_LOW_POWER],
+		    stats.cc[PECI_CC_STAT_ILLEGAL],
+		    stats.cc[PECI_CC_STAT_OTHER]);
+	shell_print(sh, "%s: xfer errors %u gated %u rejected %u trips %u",
+		    name, stats.xfer_errors, stats.gated, stats.rejected,
+		    stats.breaker_trips);
+}
+
+static int cmd_health(const struct shell *sh, size_t argc, char **argv)
+{
+	health_print(sh, "CPU", CPU);
+	health_print(sh, "GPU", GPU);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_pecihub,
+#ifdef CONFIG_PECI_CACHE
+	SHELL_CMD(cache, &sub_peci_cache, "PECI result cache", NULL),
+#endif
+	SHELL_CMD(health, NULL, "Show PECI completion codes per target",
+		  cmd_health),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(pecihub, &sub_pecihub, "PECI hub commands", NULL);
+#endif
@@ -13,6 +13,9 @@
 #ifndef __PECI_HUB_H__
 #define __PECI_HUB_H__
 
+#include <zephyr/drivers/peci.h>
+#include <zephyr/sys/slist.h>
+
 /* Delay to allow SOC to accept PECI update command */
 #define SOC_RDY_PECI_CMD_DELAY_MS 1U
 
@@ -32,6 +35,67 @@ enum peci_devices {
 	GPU,
 };
 
+/* PECI request priorities, lower values are served first */
+enum peci_prio {
+	/* Temperatures used for thermal protection */
+	PECI_PRIO_CRITICAL = 0,
+	/* Requests originated by the host or on its behalf */
+	PECI_PRIO_HOST,
+	PECI_PRIO_COUNT,
+};
+
+struct peci_req;
+
+/**
+ * @brief PECI request completion callback.
+ *
+ * Called from the PECI scheduler thread once the request is executed, or
+ * from the eSPI OOB manager thread for PECI over eSPI requests. The result
+ * is available in req->ret. Callbacks must not wait for other PECI requests.
+ */
+typedef void (*peci_req_cb_t)(struct peci_req *req);
+
+/** PECI request, owned by the scheduler until its callback is called. */
+struct peci_req {
+	sys_snode_t node;
+	struct peci_msg *msg;
+	enum peci_prio prio;
+	/* Retry on completion codes or transfer errors asking for it */
+	bool retry;
+	peci_req_cb_t done;
+	void *user_data;
+	int ret;
+	/* Attempts made so far, private to the scheduler */
+	uint8_t tries;
+	/* Uptime in ms the retry is due, private to the scheduler */
+	int64_t not_before;
+};
+
+/**
+ * @brief Queue a PECI request.
+ *
+ * Requests are served by priority and in order within the same priority.
+ * Requests queued back to back for the same target are executed in a single
+ * bus session. Only one PECI over eSPI request is outstanding at a time, so
+ * a higher priority request is sent as soon as the PCH answers.
+ *
+ * @param req the request, must remain valid until its callback is called.
+ *
+ * @retval 0 on success, -EINVAL if the request is malformed.
+ */
+int peci_submit(struct peci_req *req);
+
+/**
+ * @brief PECI scheduler task.
+ *
+ * Executes queued PECI requests and notifies their completion.
+ *
+ * @param p1 pointer to additional task-specific data.
+ * @param p2 pointer to additional task-specific data.
+ * @param p3 pointer to additional task-specific data.
+ */
+void peci_sched_thread(void *p1, void *p2, void *p3);
+
 /**
  * @brief Get CPU temperature.
  *
@@ -42,6 +106,103 @@ enum peci_devices {
  */
 int peci_get_temp(enum peci_devices dev, int *temperature);
 
+/** PECI result cache statistics. */
+struct peci_cache_stats {
+	uint32_t hits;
+	uint32_t misses;
+};
+
+/**
+ * @brief Invalidate cached PECI results.
+ *
+ * Called on platform reset, results including TjMax are read again.
+ */
+void peci_cache_invalidate(void);
+
+/**
+ * @brief Retrieve PECI result cache statistics.
+ *
+ * GetDIB and slow changing RdPkgConfig results are cached, misses count the
+ * cacheable requests completed over PECI.
+ *
+ * @param stats pointer to store the statistics.
+ */
+void peci_get_cache_stats(struct peci_cache_stats *stats);
+
+/* PECI responses counted per completion code */
+enum peci_cc_stat {
+	PECI_CC_STAT_SUCCESS = 0,
+	PECI_CC_STAT_TIMEOUT,
+	PECI_CC_STAT_OUT_OF_RESOURCES,
+	PECI_CC_STAT_LOW_POWER,
+	PECI_CC_STAT_ILLEGAL,
+	PECI_CC_STAT_OTHER,
+	PECI_CC_STAT_COUNT,
+};
+
+/** PECI target health statistics. */
+struct peci_health_stats {
+	/* Commands without completion code count as success */
+	uint32_t cc[PECI_CC_STAT_COUNT];
+	/* Bus or PECI over eSPI transfer errors */
+	uint32_t xfer_errors;
+	/* Requests skipped while CPU is in C10 or PECI is not ready */
+	uint32_t gated;
+	/* Requests rejected while the target is paused */
+	uint32_t rejected;
+	/* Times the target got paused after failing repeatedly */
+	uint32_t breaker_trips;
+};
+
+/**
+ * @brief Retrieve PECI target health statistics.
+ *
+ * Every attempt is counted, including retries.
+ *
+ * @param dev the PECI target.
+ * @param stats pointer to store the statistics.
+ *
+ * @retval 0 on success, -EINVAL if the target is unknown.
+ */
+int peci_get_health_stats(enum peci_devices dev,
+			  struct peci_health_stats *stats);
+
+/**
+ * @brief Start reading CPU or GPU temperature without waiting.
+ *
+ * Only one read per device can be outstanding, its result is collected
+ * with peci_get_temp_result(). TjMax is read instead when it is not known
+ * yet.
+ *
+ * @param dev the PECI device.
+ * @retval 0 on success, -EBUSY if previous read is not collected yet.
+ */
+int peci_get_temp_async(enum peci_devices dev);
+
+/**
+ * @brief Collect the temperature read started by peci_get_temp_async().
+ *
+ * @param dev the PECI device.
+ * @param *temperature address of temperature variable, set to fail safe
+ * temperature on error.
+ * @retval 0 on success.
+ * @retval -EINPROGRESS if read is still outstanding.
+ * @retval -ENODATA if no read was started.
+ * @retval -EAGAIN if TjMax was read, temperature is read on next start.
+ * @retval other failure code on error.
+ */
+int peci_get_temp_result(enum peci_devices dev, int *temperature);
+
+/**
+ * @brief Discard the temperature read started by peci_get_temp_async().
+ *
+ * A read still outstanding is discarded once it completes, a new read can
+ * only be started after that.
+ *
+ * @param dev the PECI device.
+ */
+void peci_get_temp_cancel(enum peci_devices dev);
+
 /**
  * @brief Get CPU maximum junction temperature.
  *
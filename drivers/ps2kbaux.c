@@ -5,11 +5,13 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/ps2.h>
 #include "board_config.h"
 #include "keyboard_utility.h"
+#include "kbchost_latency.h"
 #include "ps2kbaux.h"
 #include "kbs_keymap.h"
 #include "sci.h"
@@ -42,13 +44,82 @@ LOG_MODULE_DECLARE(kbchost, CONFIG_KBCHOST_LOG_LEVEL);
 #define F11_SC1				0x57U
 #define F12_SC1				0x58U
 #define PS2_ACK				0xFAU
+#define PS2_NACK			0xFEU
+#define PS2_ERROR			0xFCU
 
-static ps2_callback keyboard_callback;
+/* Mouse commands whose responses differ from a single ACK or that change
+ * the stream state
+ */
+#define PS2_MB_RESET			0xFFU
+#define PS2_MB_SET_DEFAULTS		0xF6U
+#define PS2_MB_DIS_REPORTING		0xF5U
+#define PS2_MB_EN_REPORTING		0xF4U
+#define PS2_MB_SET_SAMPLE_RATE		0xF3U
+#define PS2_MB_GET_ID			0xF2U
+#define PS2_MB_SET_REMOTE		0xF0U
+#define PS2_MB_SET_WRAP			0xEEU
+#define PS2_MB_READ_DATA		0xEBU
+#define PS2_MB_STATUS_REQ		0xE9U
+#define PS2_MB_SET_RESOLUTION		0xE8U
+
+/* Responses following the ACK */
+#define PS2_MB_RESET_RESP_LEN		2U
+#define PS2_MB_ID_RESP_LEN		1U
+#define PS2_MB_STATUS_RESP_LEN		3U
+
+#define PS2_MB_ID_INTELLIMOUSE		3U
+#define PS2_MB_ID_EXPLORER		4U
+#define PS2_MB_PKT_LEN			3U
+
+/* First byte of a mouse packet */
+#define PS2_MB_BUTTONS			0x07U
+#define PS2_MB_SYNC			BIT(3)
+#define PS2_MB_X_SIGN			BIT(4)
+#define PS2_MB_Y_SIGN			BIT(5)
+#define PS2_MB_OVERFLOW			(BIT(6) | BIT(7))
+
+/* Fourth byte of an IntelliMouse Explorer packet */
+#define PS2_MB_EXP_WHEEL		0x0FU
+#define PS2_MB_EXP_WHEEL_SIGN		BIT(3)
+#define PS2_MB_EXP_BUTTONS		0x30U
+
+/* Bytes of a packet are sent back to back, a longer gap means a byte was
+ * lost and the packet in progress is discarded.
+ */
+#define PS2_MB_PKT_GAP_MS		20U
+
+static ps2_kb_callback keyboard_callback;
 static ps2_callback mouse_callback;
+static ps2_mouse_packet_callback mouse_pkt_callback;
 static const struct device *keyboard_dev;
 static const struct device *mouse_dev;
 static struct km_api *keymap_api;
 static const uint8_t *current_set;
+/* Set 2 break prefix state of the PS/2 keyboard byte stream */
+static bool kb_break_code;
+
+/* Mouse byte stream state, host writes and mouse bytes are tracked to
+ * tell command responses apart from movement packets.
+ */
+static struct {
+	uint8_t pkt[PS2_MB_PKT_MAX];
+	uint8_t idx;
+	uint8_t pkt_len;
+	uint8_t id;
+	/* Last command and response bytes still expected for it */
+	uint8_t cmd;
+	uint8_t resp_left;
+	/* Next host write is the parameter of the last command */
+	bool param;
+	/* Last host write was a parameter, in case it must be resent */
+	bool resend_param;
+	bool streaming;
+	uint32_t last_byte;
+} mb_stream = {
+	.pkt_len = PS2_MB_PKT_LEN,
+};
+
+static struct k_spinlock mb_lock;
 
 enum ps2_cmd {
 	ENABLE_CALLBACK,
@@ -163,9 +234,10 @@ static int do_control_callback(enum ps2_cmd cmd, const struct device *dev)
 
 static void ps2_keyboard_callback(const struct device *dev, uint8_t value)
 {
+	uint32_t event = kb_lat_key_event();
 	int ret;
 
-	if (translate_key(*current_set, &value) != 0U) {
+	if (translate_key(*current_set, &kb_break_code, &value) != 0U) {
 		return;
 	}
 
@@ -183,8 +255,9 @@ static void ps2_keyboard_callback(const struct device *dev, uint8_t value)
 			/* Use key number to retrieve FN functionality
 			 * from custom keyboard
 			 */
-			ret = keymap_get_fnkey(keymap_api, key_num, &data,
-					 (value & BIT(KEY_RELEASED_POS)) == 0U);
+			ret = keymap_get_fnkey(keymap_api, key_num,
+					*current_set, &data,
+					(value & BIT(KEY_RELEASED_POS)) == 0U);
 			if (ret) {
 				/* No Fn Key is pressed along with CAS.
 				 * Since send CAS + Key Value.
@@ -200,18 +273,14 @@ static void ps2_keyboard_callback(const struct device *dev, uint8_t value)
 				return;
 			}
 
-			/* Retranslate to scan code set 1 since we are
-			 * using set 2 for FN keys. Or send an sci if a
-			 * corresponding FX key has an sci assigned
+			/* Send the codes already translated by the keymap.
+			 * Or send an sci if a corresponding FX key has an
+			 * sci assigned
 			 */
 			if (data.type == FN_SCAN_CODE) {
 				for (int i = 0; i < data.sc.len; i++) {
-					if (translate_key(*current_set,
-						&data.sc.code[i]) == 0U) {
-
-						keyboard_callback(
-							data.sc.code[i]);
-					}
+					keyboard_callback(data.sc.code[i],
+							  event);
 				}
 			} else {
 				if (data.sci_code != 0U) {
@@ -226,16 +295,223 @@ static void ps2_keyboard_callback(const struct device *dev, uint8_t value)
 			}
 		}
 	} else {
-		keyboard_callback(value);
+		keyboard_callback(value, event);
+	}
+}
+
+/* Must be called with mb_lock held */
+static void mb_track_write(uint8_t data)
+{
+	/* Mouse discards the packet in progress when it gets a command */
+	mb_stream.idx = 0U;
+	mb_stream.resp_left = 1U;
+	mb_stream.resend_param = mb_stream.param;
+	if (mb_stream.param) {
+		mb_stream.param = false;
+		return;
+	}
+
+	mb_stream.cmd = data;
+	switch (data) {
+	case PS2_MB_RESET:
+		mb_stream.resp_left += PS2_MB_RESET_RESP_LEN;
+		mb_stream.id = 0U;
+		mb_stream.pkt_len = PS2_MB_PKT_LEN;
+		mb_stream.streaming = false;
+		break;
+	case PS2_MB_SET_DEFAULTS:
+	case PS2_MB_DIS_REPORTING:
+	case PS2_MB_SET_REMOTE:
+	case PS2_MB_SET_WRAP:
+		mb_stream.streaming = false;
+		break;
+	case PS2_MB_GET_ID:
+		mb_stream.resp_left += PS2_MB_ID_RESP_LEN;
+		break;
+	case PS2_MB_STATUS_REQ:
+		mb_stream.resp_left += PS2_MB_STATUS_RESP_LEN;
+		break;
+	case PS2_MB_READ_DATA:
+		mb_stream.resp_left += mb_stream.pkt_len;
+		break;
+	case PS2_MB_SET_SAMPLE_RATE:
+	case PS2_MB_SET_RESOLUTION:
+		mb_stream.param = true;
+		break;
+	default:
+		break;
+	}
+}
+
+/* Must be called with mb_lock held */
+static void mb_track_response(uint8_t value)
+{
+	mb_stream.resp_left--;
+
+	/* Host resends the same byte on NACK and restarts on error */
+	if (value == PS2_NACK || value == PS2_ERROR) {
+		mb_stream.resp_left = 0U;
+		mb_stream.param = value == PS2_NACK && mb_stream.resend_param;
+		return;
+	}
+
+	switch (mb_stream.cmd) {
+	case PS2_MB_EN_REPORTING:
+		if (value == PS2_ACK) {
+			mb_stream.streaming = true;
+		}
+		break;
+	case PS2_MB_GET_ID:
+		/* IntelliMouse wheel is reported in a 4th byte */
+		if (!mb_stream.resp_left) {
+			mb_stream.id = value;
+			mb_stream.pkt_len =
+				(value == PS2_MB_ID_INTELLIMOUSE ||
+				 value == PS2_MB_ID_EXPLORER) ?
+				PS2_MB_PKT_MAX : PS2_MB_PKT_LEN;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/* Must be called with mb_lock held, returns the length of a completed
+ * packet copied to pkt or 0.
+ */
+static uint8_t mb_assemble(uint8_t value, uint8_t *pkt)
+{
+	uint32_t now = k_uptime_get_32();
+	uint8_t len;
+
+	if (mb_stream.idx && now - mb_stream.last_byte > PS2_MB_PKT_GAP_MS) {
+		mb_stream.idx = 0U;
+	}
+
+	mb_stream.last_byte = now;
+
+	/* Out of sync, wait for a byte that can start a packet */
+	if (!mb_stream.idx && !(value & PS2_MB_SYNC)) {
+		return 0U;
+	}
+
+	mb_stream.pkt[mb_stream.idx++] = value;
+	if (mb_stream.idx < mb_stream.pkt_len) {
+		return 0U;
 	}
+
+	len = mb_stream.pkt_len;
+	memcpy(pkt, mb_stream.pkt, len);
+	mb_stream.idx = 0U;
+
+	return len;
 }
 
 static void ps2_mouse_callback(const struct device *dev, uint8_t value)
 {
-	mouse_callback(value);
+	uint8_t pkt[PS2_MB_PKT_MAX];
+	uint8_t len = 0U;
+	bool stream = false;
+	k_spinlock_key_t key = k_spin_lock(&mb_lock);
+
+	if (mb_stream.resp_left) {
+		mb_track_response(value);
+	} else if (mb_stream.streaming) {
+		stream = true;
+		len = mb_assemble(value, pkt);
+	}
+
+	k_spin_unlock(&mb_lock, key);
+
+	if (!stream) {
+		mouse_callback(value);
+	} else if (len) {
+		mouse_pkt_callback(pkt, len);
+	}
+}
+
+static int mb_delta(uint8_t value, bool negative)
+{
+	return negative ? (int)value - 256 : value;
 }
 
-int ps2_keyboard_init(const ps2_callback callback, uint8_t *initial_set)
+/* Explorer wheel is a 4 bit two's complement value */
+static int mb_exp_wheel(uint8_t value)
+{
+	int z = value & PS2_MB_EXP_WHEEL;
+
+	return (value & PS2_MB_EXP_WHEEL_SIGN) ? z - 16 : z;
+}
+
+bool ps2_mouse_coalesce(uint8_t *queued, const uint8_t *packet, uint8_t len)
+{
+	uint8_t flags = packet[0] & ~(PS2_MB_X_SIGN | PS2_MB_Y_SIGN);
+	uint8_t wheel = 0U;
+	k_spinlock_key_t key;
+	uint8_t id;
+	int x;
+	int y;
+	int z;
+
+	/* Mouse id changes when host sets the sample rate sequence */
+	key = k_spin_lock(&mb_lock);
+	id = mb_stream.id;
+	k_spin_unlock(&mb_lock, key);
+
+	/* Button transitions must reach the host as separate packets */
+	if ((queued[0] ^ packet[0]) & PS2_MB_BUTTONS ||
+	    (queued[0] | packet[0]) & PS2_MB_OVERFLOW) {
+		return false;
+	}
+
+	x = mb_delta(queued[1], queued[0] & PS2_MB_X_SIGN) +
+	    mb_delta(packet[1], packet[0] & PS2_MB_X_SIGN);
+	y = mb_delta(queued[2], queued[0] & PS2_MB_Y_SIGN) +
+	    mb_delta(packet[2], packet[0] & PS2_MB_Y_SIGN);
+	if (x < -256 || x > 255 || y < -256 || y > 255) {
+		return false;
+	}
+
+	if (len == PS2_MB_PKT_MAX && id == PS2_MB_ID_EXPLORER) {
+		if ((queued[3] ^ packet[3]) & PS2_MB_EXP_BUTTONS) {
+			return false;
+		}
+
+		z = mb_exp_wheel(queued[3]) + mb_exp_wheel(packet[3]);
+		if (z < -8 || z > 7) {
+			return false;
+		}
+
+		wheel = (packet[3] & PS2_MB_EXP_BUTTONS) |
+			(z & PS2_MB_EXP_WHEEL);
+	} else if (len == PS2_MB_PKT_MAX) {
+		z = (int8_t)queued[3] + (int8_t)packet[3];
+		if (z < INT8_MIN || z > INT8_MAX) {
+			return false;
+		}
+
+		wheel = (uint8_t)z;
+	}
+
+	if (x < 0) {
+		flags |= PS2_MB_X_SIGN;
+	}
+
+	if (y < 0) {
+		flags |= PS2_MB_Y_SIGN;
+	}
+
+	queued[0] = flags;
+	queued[1] = (uint8_t)x;
+	queued[2] = (uint8_t)y;
+	if (len == PS2_MB_PKT_MAX) {
+		queued[3] = wheel;
+	}
+
+	return true;
+}
+
+int ps2_keyboard_init(const ps2_kb_callback callback, uint8_t *initial_set)
 {
 
 	int ret;
@@ -289,11 +565,12 @@ void ps2_keyboard_enable(void)
 	}
 }
 
-int ps2_mouse_init(ps2_callback callback)
+int ps2_mouse_init(ps2_callback callback,
+		   ps2_mouse_packet_callback pkt_callback)
 {
 	int ret;
 
-	if (!callback) {
+	if (!callback || !pkt_callback) {
 		LOG_ERR("Bad callback");
 		return -EINVAL;
 	}
@@ -312,12 +589,18 @@ int ps2_mouse_init(ps2_callback callback)
 	}
 
 	mouse_callback = callback;
+	mouse_pkt_callback = pkt_callback;
 
 	return 0;
 }
 
 void ps2_mouse_write(uint8_t data)
 {
+	k_spinlock_key_t key = k_spin_lock(&mb_lock);
+
+	mb_track_write(data);
+	k_spin_unlock(&mb_lock, key);
+
 	if (ps2_write(mouse_dev, data)) {
 		LOG_ERR("PS/2 mb write failed");
 	}
@@ -15,6 +15,20 @@
 
 typedef void (*ps2_callback)(uint8_t data);
 
+/* Event is the key event timestamp for latency tracing, 0 if not traced */
+typedef void (*ps2_kb_callback)(uint8_t data, uint32_t event);
+
+/* Longest mouse packet, IntelliMouse adds a 4th byte for the wheel */
+#define PS2_MB_PKT_MAX			4U
+
+/**
+ * @brief Callback notifying a complete mouse movement packet.
+ *
+ * @param packet the packet bytes, first byte holds buttons and sign bits.
+ * @param len 3 for standard PS/2 mice or 4 for IntelliMouse.
+ */
+typedef void (*ps2_mouse_packet_callback)(const uint8_t *packet, uint8_t len);
+
 /**
  * @brief Initialize PS/2 instance representing the keyboard.
  *
@@ -25,7 +39,7 @@ typedef void (*ps2_callback)(uint8_t data);
  * @retval 0 if successful.
  * @retval negative on error code.
  */
-int ps2_keyboard_init(ps2_callback callback, uint8_t *initial_set);
+int ps2_keyboard_init(ps2_kb_callback callback, uint8_t *initial_set);
 
 /**
  * @brief Write commands or data to PS/2 Keyboard.
@@ -55,24 +69,47 @@ void ps2_keyboard_enable(void);
 /**
  * @brief Initialize PS/2 instance representing the mouse.
  *
- * This routine receives a callback to notify mouse events.
+ * This routine receives callbacks to notify mouse events. Once the host
+ * enables data reporting, stream bytes are assembled into packets and only
+ * whole packets are notified. Bytes whose sync bit is clear or that arrive
+ * too late to belong to the current packet are discarded until the stream
+ * is in sync again. Command responses and any other byte are notified one
+ * at a time.
  *
- * @param ps2_callback Pointer to a function implemented in the caller code.
+ * @param callback Pointer to a function notified of single bytes.
+ * @param pkt_callback Pointer to a function notified of movement packets.
  *
  * @retval 0 if successful.
  * @retval negative on error code.
  */
-int ps2_mouse_init(ps2_callback callback);
+int ps2_mouse_init(ps2_callback callback,
+		   ps2_mouse_packet_callback pkt_callback);
 
 /**
  * @brief Write commands or data to PS/2 mouse.
  *
- * This routine writes data bytes to the mouse.
+ * This routine writes data bytes to the mouse. Commands are tracked to
+ * tell their responses apart from movement packets and to detect the
+ * IntelliMouse packet format.
  *
- * @param ps2_callback Pointer to a function implemented in the caller code.
+ * @param data Byte value representing either command or data.
  */
 void ps2_mouse_write(uint8_t data);
 
+/**
+ * @brief Merge a mouse packet into one not yet sent to the host.
+ *
+ * Movement and wheel deltas are added up as long as the buttons didn't
+ * change and the sums are representable without overflow.
+ *
+ * @param queued packet waiting to be sent, updated with the merged deltas.
+ * @param packet newer packet of the same length.
+ * @param len the packet length.
+ *
+ * @retval true if the packets were merged, false otherwise.
+ */
+bool ps2_mouse_coalesce(uint8_t *queued, const uint8_t *packet, uint8_t len);
+
 /**
  * @brief Disable the PS/2 instance representing the mouse.
  *
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include "bench.h"
+
+int bench_wait_sts(bench_read_sts read_sts, uint8_t flag, bool set,
+		   uint32_t timeout_us)
+{
+	for (uint32_t t = 0; t < timeout_us; t += BENCH_POLL_US) {
+		if (!!(read_sts() & flag) == set) {
+			return 0;
+		}
+
+		k_usleep(BENCH_POLL_US);
+	}
+
+	return -ETIMEDOUT;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+void bench_run(bench_iter fn, void *ctx, uint32_t iterations,
+	       struct bench_samples *samples, struct bench_result *res)
+{
+	uint32_t count;
+	uint32_t start;
+	uint32_t elapsed_us;
+
+	memset(res, 0, sizeof(*res));
+	samples->count = 0;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < iterations; i++) {
+		if (fn(i, samples, ctx)) {
+			res->errors++;
+		}
+	}
+	elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	res->per_sec = (uint32_t)((uint64_t)(iterations - res->errors) *
+				  USEC_PER_SEC / MAX(elapsed_us, 1));
+
+	count = samples->count;
+	res->samples = count;
+	if (!count) {
+		return;
+	}
+
+	qsort(samples->buf, count, sizeof(samples->buf[0]), cmp_u32);
+	res->p50_us = samples->buf[count / 2];
+	res->p99_us = samples->buf[(count * 99) / 100];
+	res->max_us = samples->buf[count - 1];
+}
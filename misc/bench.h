@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Helpers shared by host interface benchmarks.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Emulated host polling interval and timeout for each handshake */
+#define BENCH_POLL_US		10u
+#define BENCH_TIMEOUT_US	100000u
+
+/** Latency samples in microseconds collected during a run. */
+struct bench_samples {
+	uint32_t *buf;
+	uint32_t size;
+	uint32_t count;
+};
+
+/** Benchmark run results, latencies are in microseconds. */
+struct bench_result {
+	uint32_t per_sec;
+	uint32_t p50_us;
+	uint32_t p99_us;
+	uint32_t max_us;
+	uint32_t errors;
+	uint32_t samples;
+};
+
+/**
+ * @brief Read the status register of the emulated host interface.
+ */
+typedef uint8_t (*bench_read_sts)(void);
+
+/**
+ * @brief Run one benchmark iteration.
+ *
+ * @param iter iteration number.
+ * @param samples latency samples to add to with bench_sample_add().
+ * @param ctx context passed to bench_run().
+ *
+ * @retval 0 if the iteration succeeded, negative error code otherwise.
+ */
+typedef int (*bench_iter)(uint32_t iter, struct bench_samples *samples,
+			  void *ctx);
+
+static inline void bench_sample_add(struct bench_samples *samples,
+				    uint32_t us)
+{
+	if (samples->count < samples->size) {
+		samples->buf[samples->count++] = us;
+	}
+}
+
+/**
+ * @brief Wait until a status flag reaches the expected value like OS does.
+ *
+ * @param read_sts status register accessor.
+ * @param flag status flag mask.
+ * @param set expected flag value.
+ * @param timeout_us time to wait in microseconds.
+ *
+ * @retval 0 if the flag reached the value, -ETIMEDOUT otherwise.
+ */
+int bench_wait_sts(bench_read_sts read_sts, uint8_t flag, bool set,
+		   uint32_t timeout_us);
+
+/**
+ * @brief Run a benchmark and compute its results.
+ *
+ * Iterations per second only count successful iterations, percentiles are
+ * computed over all the samples added by the iterations.
+ *
+ * @param fn iteration to run.
+ * @param ctx context passed to every iteration.
+ * @param iterations number of iterations.
+ * @param samples buffer for the latency samples, count is reset.
+ * @param res pointer to store the results.
+ */
+void bench_run(bench_iter fn, void *ctx, uint32_t iterations,
+	       struct bench_samples *samples, struct bench_result *res);
+
+#endif /* __BENCH_H__ */
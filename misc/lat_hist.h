@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Log2 latency histogram helpers shared by latency tracing modules.
+ *
+ * Bucket n holds samples in [2^(n-1), 2^n) us, the last bucket holds every
+ * sample above. Counters saturate instead of wrapping around.
+ */
+
+#ifndef __LAT_HIST_H__
+#define __LAT_HIST_H__
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+static inline void lat_sat_inc(uint16_t *counter)
+{
+	if (*counter < UINT16_MAX) {
+		(*counter)++;
+	}
+}
+
+static inline uint16_t lat_sat_u16(uint32_t value)
+{
+	return (uint16_t)MIN(value, UINT16_MAX);
+}
+
+/**
+ * @brief Account a latency sample in a histogram.
+ *
+ * @param hist histogram buckets.
+ * @param buckets number of buckets in hist.
+ * @param us latency in microseconds.
+ */
+static inline void lat_hist_add(uint16_t *hist, uint32_t buckets,
+				uint32_t us)
+{
+	lat_sat_inc(&hist[MIN(find_msb_set(us), buckets - 1)]);
+}
+
+#ifdef CONFIG_SHELL
+/**
+ * @brief Print the non-empty buckets of a histogram, the last bucket is
+ * always printed.
+ *
+ * @param sh shell instance.
+ * @param hist histogram buckets.
+ * @param buckets number of buckets in hist.
+ */
+static inline void lat_hist_print(const struct shell *sh,
+				  const uint16_t *hist, uint32_t buckets)
+{
+	for (uint32_t b = 0; b < buckets - 1; b++) {
+		if (hist[b]) {
+			shell_print(sh, "  < %lu us: %u", BIT(b), hist[b]);
+		}
+	}
+
+	shell_print(sh, "  >= %lu us: %u", BIT(buckets - 2),
+		    hist[buckets - 1]);
+}
+#endif
+
+#endif /* __LAT_HIST_H__ */
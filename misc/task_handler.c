@@ -18,6 +18,7 @@
 #include "task_handler.h"
 #ifdef CONFIG_THERMAL_MANAGEMENT
 #include "thermalmgmt.h"
+#include "peci_hub.h"
 #endif
 
 LOG_MODULE_DECLARE(pwrmgmt, CONFIG_PWRMGT_LOG_LEVEL);
@@ -71,11 +72,26 @@ K_THREAD_DEFINE(smchost_thrd_id, EC_TASK_STACK_SIZE, smchost_thread,
 		&smchost_thrd_period, NULL, NULL, EC_TASK_PRIORITY,
 		K_INHERIT_PERMS, EC_WAIT_FOREVER);
 
+#ifdef CONFIG_SMCHOST_ACPI_BENCH
+K_THREAD_DEFINE(acpi_bench_thrd_id, EC_TASK_STACK_SIZE, smchost_bench_thread,
+		NULL, NULL, NULL, K_PRIO_PREEMPT(1), K_INHERIT_PERMS,
+		EC_WAIT_FOREVER);
+#endif
+
+#ifdef CONFIG_KBCHOST_BENCH
+K_THREAD_DEFINE(kbc_bench_thrd_id, EC_TASK_STACK_SIZE, kbchost_bench_thread,
+		NULL, NULL, NULL, K_PRIO_PREEMPT(1), K_INHERIT_PERMS,
+		EC_WAIT_FOREVER);
+#endif
+
 #ifdef CONFIG_THERMAL_MANAGEMENT
-const uint32_t thermal_thrd_period = 250;
+const uint32_t thermal_thrd_period = CONFIG_THERMAL_POLL_MIN_MS;
 K_THREAD_DEFINE(thermal_thrd_id, EC_TASK_STACK_SIZE, thermalmgmt_thread,
 		&thermal_thrd_period, NULL, NULL, EC_TASK_PRIORITY,
 		K_INHERIT_PERMS, EC_WAIT_FOREVER);
+K_THREAD_DEFINE(peci_thrd_id, EC_TASK_STACK_SIZE, peci_sched_thread,
+		NULL, NULL, NULL, EC_TASK_PRIORITY,
+		K_INHERIT_PERMS, EC_WAIT_FOREVER);
 #endif
 
 
@@ -117,9 +133,22 @@ static struct task_info tasks[] = {
 	{ .thread_id = smchost_thrd_id, .can_suspend = false,
 	  .tagname = "SMC" },
 
+#ifdef CONFIG_SMCHOST_ACPI_BENCH
+	{ .thread_id = acpi_bench_thrd_id, .can_suspend = false,
+	  .tagname = "ACPIBENCH" },
+#endif
+
+#ifdef CONFIG_KBCHOST_BENCH
+	{ .thread_id = kbc_bench_thrd_id, .can_suspend = false,
+	  .tagname = "KBCBENCH" },
+#endif
+
 #ifdef CONFIG_THERMAL_MANAGEMENT
 	{ .thread_id = thermal_thrd_id, .can_suspend = false,
 	  .tagname = THRML_MGMT_TASK_NAME },
+
+	{ .thread_id = peci_thrd_id, .can_suspend = false,
+	  .tagname = "PECI" },
 #endif
 };
 
@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate a keyboard keymap implementation from its description.
+
+The description in drivers/keymaps/<name>.yaml lists the IBM key number
+of every matrix position and the Fn layer of the keyboard. The output is
+a C file with packed const tables and the struct km_api implementation
+returned by kbs_keymap_init(). Fn layer codes are stored already
+translated for both scan code set modes, like gen_kbs_scancode_tbl.py
+does for the other keys. It is invoked by the build system for the
+keymap selected by CONFIG_KBS_KEYMAP.
+
+Usage:
+  scripts/gen_kbs_keymap.py drivers/keymaps/gtech.yaml kbs_keymap_gen.c
+"""
+
+import os
+import re
+import sys
+
+import yaml
+
+# Keep the source tree free of bytecode for the imported generator
+sys.dont_write_bytecode = True
+
+from gen_kbs_scancode_tbl import (  # noqa: E402
+    MAX_SCAN_CODE_LEN, break_of, load_xlat, to_set1)
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+KEYMAP_HEADER = os.path.join(ROOT, 'drivers', 'kbs_keymap.h')
+
+HEADER = '''\
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generated by scripts/gen_kbs_keymap.py from %s,
+ * do not edit.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include "kbs_keymap.h"
+#include "keyboard_utility.h"
+'''
+
+FN_STRUCT = '''
+/* Fn layer entry indexed by the scan code set selected by the host, make
+ * and break codes are stored back to back at the code offset of
+ * kbs_keymap_fn_codes. SCI entries hold the SCI in the first code instead.
+ */
+struct kbs_keymap_fn {
+	uint8_t type;
+	uint8_t code[2];
+	uint8_t make_len[2];
+	uint8_t break_len[2];
+	bool typematic;
+};
+'''
+
+FN_IMPL = '''
+static int kbs_keymap_get_fnkey(uint8_t key_num, uint8_t set,
+				struct fn_data *data, bool pressed)
+{
+	const struct kbs_keymap_fn *fn;
+	const uint8_t *codes;
+	uint8_t idx = set - SCAN_CODE_SET1;
+	uint8_t len;
+
+	if (key_num >= KBS_KEYMAP_FN_KEYS || !kbs_keymap_fn_idx[key_num] ||
+	    set < SCAN_CODE_SET1 || set > SCAN_CODE_SET2) {
+		return -EINVAL;
+	}
+
+	fn = &kbs_keymap_fn[kbs_keymap_fn_idx[key_num] - 1U];
+	data->type = fn->type;
+	if (fn->type == SCI_CODE) {
+		/* Clients do nothing with the release of an SCI */
+		data->sci_code = pressed ? fn->code[0] : 0U;
+		return 0;
+	}
+
+	codes = &kbs_keymap_fn_codes[fn->code[idx]];
+	len = fn->make_len[idx];
+	if (!pressed) {
+		codes += fn->make_len[idx];
+		len = fn->break_len[idx];
+	}
+
+	/* Nothing is sent for unmapped codes */
+	data->sc.code[0] = SC_UNMAPPED;
+	memcpy(data->sc.code, codes, len);
+	data->sc.len = len;
+	data->sc.typematic = pressed && fn->typematic;
+
+	return 0;
+}
+'''
+
+KEYNUM_IMPL = '''
+#ifdef CONFIG_KSCAN_EC
+static int kbs_keymap_get_keynum(uint8_t col, uint8_t row)
+{
+	if (col >= KBS_KEYMAP_COLS || row >= KBS_KEYMAP_ROWS) {
+		return -EINVAL;
+	}
+
+	return kbs_keymap_mtx[col * KBS_KEYMAP_ROWS + row];
+}
+#endif
+'''
+
+API_IMPL = '''
+static struct km_api kbs_keymap_api = {
+#ifdef CONFIG_KSCAN_EC
+	.get_keynum = kbs_keymap_get_keynum,
+#endif
+	.get_fnkey = %s,
+};
+
+struct km_api *kbs_keymap_init(void)
+{
+	return &kbs_keymap_api;
+}
+'''
+
+
+def fail(desc, msg):
+    sys.exit('%s: %s' % (desc, msg))
+
+
+def load_key_names():
+    """Numeric KM_* key numbers defined in kbs_keymap.h."""
+    with open(KEYMAP_HEADER) as f:
+        text = f.read()
+
+    return {name: int(value) for name, value in
+            re.findall(r'#define\s+(KM_\w+)\s+(\d+)U?\b', text)}
+
+
+def key_num(desc, names, key):
+    if isinstance(key, str):
+        if key not in names:
+            fail(desc, 'unknown key %s' % key)
+        return names[key], key
+
+    if not 0 <= key <= 255:
+        fail(desc, 'bad key number %d' % key)
+
+    return key, '%dU' % key
+
+
+def codes_of(desc, key, codes):
+    if len(codes) > MAX_SCAN_CODE_LEN or any(not 0 <= c <= 255
+                                             for c in codes):
+        fail(desc, 'bad scan code for key %s' % key)
+
+    return codes
+
+
+def c_bytes(codes, width=80):
+    """Tab indented lines of comma separated bytes wrapped at width."""
+    lines = []
+    line = ''
+    for code in codes:
+        item = '0x%02XU,' % code
+        if line and len(('\t%s %s' % (line, item)).expandtabs(8)) > width:
+            lines.append('\t' + line)
+            line = ''
+        line = '%s %s' % (line, item) if line else item
+    if line:
+        lines.append('\t' + line)
+
+    return lines
+
+
+def gen_matrix(desc, keymap, out):
+    cols = keymap['columns']
+    rows = keymap['rows']
+    matrix = keymap['matrix']
+
+    if len(matrix) != cols or any(len(col) != rows for col in matrix):
+        fail(desc, 'matrix must be %d columns of %d rows' % (cols, rows))
+
+    out.append('#ifdef CONFIG_KSCAN_EC')
+    out.append('/* Key numbers indexed by col * KBS_KEYMAP_ROWS + row */')
+    out.append('static const uint8_t '
+               'kbs_keymap_mtx[KBS_KEYMAP_COLS * KBS_KEYMAP_ROWS] = {')
+    for num, col in enumerate(matrix):
+        for key in col:
+            if not 0 <= key <= 255:
+                fail(desc, 'bad key number %d in column %d' % (key, num))
+        out.append('\t%s\t/* %d */' % (
+            ', '.join('%dU' % k for k in col) + ',', num))
+    out.append('};')
+    out.append('#endif')
+
+
+def gen_fn(desc, keymap, names, out):
+    entries = []
+    pool = []
+    idx = {}
+    xlat = load_xlat()
+
+    for fn in keymap.get('fn', []):
+        num, name = key_num(desc, names, fn['key'])
+        if num in idx:
+            fail(desc, 'key %s defined twice in fn layer' % name)
+
+        if 'sci' in fn:
+            entries.append((name, 'SCI_CODE', [fn['sci'], 0], [0, 0],
+                            [0, 0], False))
+        else:
+            make = codes_of(desc, name, fn['make'])
+            brk = codes_of(desc, name, fn.get('break', break_of(make)))
+            typematic = bool(fn.get('typematic', False))
+            offsets, make_lens, brk_lens = [], [], []
+            # Indexed like kbs_sc_tbl, set 2 is translated to set 1
+            for codes in ((make, brk),
+                          (to_set1(xlat, make), to_set1(xlat, brk))):
+                offsets.append(len(pool))
+                make_lens.append(len(codes[0]))
+                brk_lens.append(len(codes[1]))
+                pool += codes[0] + codes[1]
+            entries.append((name, 'FN_SCAN_CODE', offsets, make_lens,
+                            brk_lens, typematic))
+        idx[num] = (len(entries), name)
+
+    if len(pool) > 255:
+        fail(desc, 'fn layer codes exceed 255 bytes')
+
+    if not entries:
+        return False
+
+    out.append('')
+    out.append('#define KBS_KEYMAP_FN_KEYS\t%dU' % (max(idx) + 1))
+    out.append('')
+    out.append('static const uint8_t kbs_keymap_fn_codes[] = {')
+    out += c_bytes(pool)
+    out.append('};')
+    out.append(FN_STRUCT.rstrip('\n'))
+    out.append('')
+    out.append('static const struct kbs_keymap_fn kbs_keymap_fn[] = {')
+    for name, kind, code, make_len, brk_len, typematic in entries:
+        fmt = '0x%02XU' if kind == 'SCI_CODE' else '%dU'
+        out.append('\t/* %s */' % name)
+        out.append('\t{%s, {%s}, {%s}, {%s}, %s},' % (
+            kind, ', '.join(fmt % c for c in code),
+            ', '.join('%dU' % n for n in make_len),
+            ', '.join('%dU' % n for n in brk_len),
+            'true' if typematic else 'false'))
+    out.append('};')
+    out.append('')
+    out.append('/* Fn layer entry + 1 indexed by key number, 0 if none */')
+    out.append('static const uint8_t kbs_keymap_fn_idx[KBS_KEYMAP_FN_KEYS] '
+               '= {')
+    for num in sorted(idx):
+        entry, name = idx[num]
+        out.append('\t[%s] = %dU,' % (name, entry))
+    out.append('};')
+    out.append('')
+    out.append(FN_IMPL.strip('\n'))
+
+    return True
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    desc, output = sys.argv[1], sys.argv[2]
+    with open(desc) as f:
+        keymap = yaml.safe_load(f)
+
+    names = load_key_names()
+    out = [HEADER % os.path.relpath(desc, ROOT)]
+    out.append('#define KBS_KEYMAP_COLS\t\t%dU' % keymap['columns'])
+    out.append('#define KBS_KEYMAP_ROWS\t\t%dU' % keymap['rows'])
+    out.append('')
+    gen_matrix(desc, keymap, out)
+    has_fn = gen_fn(desc, keymap, names, out)
+    out.append(KEYNUM_IMPL.rstrip('\n'))
+    out.append(API_IMPL.rstrip('\n') %
+               ('kbs_keymap_get_fnkey' if has_fn else 'NULL'))
+
+    with open(output, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
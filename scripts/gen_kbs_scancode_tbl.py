@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2024 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate the scan matrix make/break scan code tables.
+
+Every key number, plus the numlock, print screen and pause variants, is
+mapped to the final make and break byte strings sent to the host for both
+scan code set modes handled by kbs_matrix. Set 2 to set 1 translation uses
+kb_translation_table from app/kbchost/keyboard_utility.h. The header is
+written to the build directory by the build system, which runs the script
+again whenever it or keyboard_utility.h change.
+
+Usage:
+  scripts/gen_kbs_scancode_tbl.py kbs_scancode_tbl.h
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+XLAT_HEADER = os.path.join(ROOT, 'app', 'kbchost', 'keyboard_utility.h')
+
+MAX_SCAN_CODE_LEN = 8
+START_BREAK_CODE = 0xF0
+EXTENDED_CODE = 0xE0
+
+# Scan code set 2 make codes indexed by IBM key number. Print screen (124)
+# and pause (126) are left empty, their variants are listed separately.
+SET2_KEYS = [
+    [], [0x0E], [0x16], [0x1E], [0x26], [0x25], [0x2E], [0x36],         # 0
+    [0x3D], [0x3E], [0x46], [0x45], [0x4E], [0x55], [0x00], [0x66],     # 8
+    [0x0D], [0x15], [0x1D], [0x24], [0x2D], [0x2C], [0x35], [0x3C],     # 16
+    [0x43], [0x44], [0x4D], [0x54], [0x5B], [0x5D], [0x58], [0x1C],     # 24
+    [0x1B], [0x23], [0x2B], [0x34], [0x33], [0x3B], [0x42], [0x4B],     # 32
+    [0x4C], [0x52], [0x5D], [0x5A], [0x12], [0x61], [0x1A], [0x22],     # 40
+    [0x21], [0x2A], [0x32], [0x31], [0x3A], [0x41], [0x49], [0x4A],     # 48
+    [], [0x59], [0x14], [], [0x11], [0x29], [0xE0, 0x11], [],           # 56
+    [0xE0, 0x14], [], [], [], [], [], [], [],                           # 64
+    [], [], [], [0xE0, 0x70], [0xE0, 0x71], [], [], [0xE0, 0x6B],       # 72
+    [0xE0, 0x6C], [0xE0, 0x69], [], [0xE0, 0x75], [0xE0, 0x72],         # 80
+    [0xE0, 0x7D], [0xE0, 0x7A], [],                                     # 85
+    [], [0xE0, 0x74], [0x77], [0x6C], [0x6B], [0x69], [], [0xE0, 0x4A], # 88
+    [0x75], [0x73], [0x72], [0x70], [0x7C], [0x7D], [0x74], [0x7A],     # 96
+    [0x71], [0x7B], [0x79], [], [0xE0, 0x5A], [], [0x76], [],           # 104
+    [0x05], [0x06], [0x04], [0x0C], [0x03], [0x0B], [0x83], [0x0A],     # 112
+    [0x01], [0x09], [0x78], [0x07], [], [0x7E], [], [0xE0, 0x1F],       # 120
+    [0x29], [0xE0, 0x2F],                                               # 128
+]
+
+# Numeric codes for keyboards with numlock button but no keypad
+SET2_NUMPAD = [
+    ('KM_KEY_7', 8, 0x6C),
+    ('KM_KEY_8', 9, 0x75),
+    ('KM_KEY_9', 10, 0x7D),
+    ('KM_KEY_0', 11, 0x4A),
+    ('KM_KEY_U_4', 23, 0x6B),
+    ('KM_KEY_5_I', 24, 0x73),
+    ('KM_KEY_6_O', 25, 0x74),
+    ('KM_KEY_P_MUL', 26, 0x7C),
+    ('KM_KEY_1_J', 37, 0x69),
+    ('KM_KEY_2_K', 38, 0x72),
+    ('KM_KEY_3_L', 39, 0x7A),
+    ('KM_KEY_MINUS_SEMI', 40, 0x4E),
+    ('KM_KEY_0_M', 52, 0x70),
+    ('KM_KEY_DOT', 54, 0x71),
+    ('KM_KEY_PLUS_SLASH', 55, 0x79),
+]
+
+# Variant rows: name, make, break, typematic
+SET2_VARIANTS = [
+    ('PRTSC', [0xE0, 0x12, 0xE0, 0x7C],
+     [0xE0, 0xF0, 0x7C, 0xE0, 0xF0, 0x12], True),
+    ('PRTSC_ALT', [0x84], [0xF0, 0x84], True),
+    ('PRTSC_CTRL_SHIFT', [0xE0, 0x7C], [0xF0, 0xE0, 0x7C], True),
+    # Pause/break have neither typematic nor break code
+    ('PAUSE', [0xE1, 0x14, 0x77, 0xE1, 0xF0, 0x14, 0xF0, 0x77], [], False),
+    ('PAUSE_CTRL', [0xE0, 0x7E, 0xE0, 0xF0, 0x7E], [], False),
+]
+
+TBL_HEADER = '''\
+/* Final make and break codes indexed by the scan code set selected by
+ * the host. Set 2 codes are translated to set 1 as translate_key() does.
+ */
+static const struct scan_code
+kbs_sc_tbl[][KBS_SC_ROWS][2] = {'''
+
+
+def load_xlat():
+    with open(XLAT_HEADER) as f:
+        text = f.read()
+
+    body = re.search(r'kb_translation_table\[\]\s*=\s*\{(.*?)\};', text,
+                     re.S).group(1)
+    body = re.sub(r'/\*.*?\*/', '', body, flags=re.S)
+    table = [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+    if len(table) != 256:
+        sys.exit('unexpected kb_translation_table size %d' % len(table))
+
+    return table
+
+
+def break_of(make):
+    """Set 2 break code, 0xF0 goes ahead of every non extended byte."""
+    codes = []
+    for code in make:
+        if code != EXTENDED_CODE:
+            codes.append(START_BREAK_CODE)
+        codes.append(code)
+
+    return codes
+
+
+def to_set1(xlat, codes):
+    """Same translation as translate_key() applied to a whole sequence."""
+    out = []
+    found_break = False
+    for code in codes:
+        if code == START_BREAK_CODE:
+            found_break = True
+            continue
+
+        value = xlat[code]
+        if found_break:
+            value |= 0x80
+            found_break = False
+        out.append(value)
+
+    return out
+
+
+def fmt_code(codes, typematic):
+    if len(codes) > MAX_SCAN_CODE_LEN:
+        sys.exit('scan code too long %s' % codes)
+
+    values = ', '.join('0x%02XU' % c for c in codes) if codes else '0U'
+    return '{{%s}, %dU, %s}' % (values, len(codes),
+                                'true' if typematic else 'false')
+
+
+def emit_row(rows, make, brk, typematic, comment):
+    mk = fmt_code(make, typematic and bool(make))
+    bk = fmt_code(brk, False)
+    line = '\t{%s, %s},\t/* %s */' % (mk, bk, comment)
+    if len(line.expandtabs(8)) <= 80:
+        rows.append(line)
+    else:
+        rows.append('\t/* %s */' % comment)
+        rows.append('\t{%s,' % mk)
+        rows.append('\t %s},' % bk)
+
+
+def define(name, value):
+    macro = '#define %s' % name
+    tabs = max(1, (40 - len(macro) + 7) // 8)
+    return '%s%s%s' % (macro, '\t' * tabs, value)
+
+
+def main(output):
+    xlat = load_xlat()
+    keys = len(SET2_KEYS)
+    rows = []
+
+    for make in SET2_KEYS:
+        rows.append((make, break_of(make), True))
+    for _, _, code in SET2_NUMPAD:
+        rows.append(([code], break_of([code]), True))
+    for _, make, brk, typematic in SET2_VARIANTS:
+        rows.append((make, brk, typematic))
+
+    names = ['%d' % i for i in range(keys)]
+    names += ['numpad %s' % n for n, _, _ in SET2_NUMPAD]
+    names += [n.lower().replace('_', ' ') for n, _, _, _ in SET2_VARIANTS]
+
+    out = []
+    out.append('''/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generated by scripts/gen_kbs_scancode_tbl.py, do not edit. */
+
+#ifndef __KBS_SCANCODE_TBL_H__
+#define __KBS_SCANCODE_TBL_H__
+
+#include "kbs_keymap.h"
+#include "keyboard_utility.h"
+''')
+    out.append(define('KBS_SC_KEYS', '%dU' % keys))
+    out.append(define('KBS_SC_ROW_NUMPAD', '%dU' % keys))
+    row = keys + len(SET2_NUMPAD)
+    for name, _, _, _ in SET2_VARIANTS:
+        out.append(define('KBS_SC_ROW_%s' % name, '%dU' % row))
+        row += 1
+    out.append(define('KBS_SC_ROWS', '%dU' % row))
+    out.append('')
+    out.append(define('KBS_SC_MAKE', '0U'))
+    out.append(define('KBS_SC_BREAK', '1U'))
+    out.append('')
+    out.append('/* Row used by key numbers with numlock on, 0 if none */')
+    out.append('static const uint8_t kbs_sc_numpad_row[KBS_SC_KEYS] = {')
+    for i, (name, key, _) in enumerate(SET2_NUMPAD):
+        out.append('\t[%s] = KBS_SC_ROW_NUMPAD + %dU,' % (name, i))
+    out.append('};')
+    out.append('')
+    out.append(TBL_HEADER)
+
+    for name, conv in (('SCAN_CODE_SET1', lambda c: c),
+                       ('SCAN_CODE_SET2', lambda c: to_set1(xlat, c))):
+        out.append('[%s - SCAN_CODE_SET1] = {' % name)
+        for (make, brk, typematic), comment in zip(rows, names):
+            emit_row(out, conv(make), conv(brk), typematic, comment)
+        out.append('},')
+
+    out.append('};')
+    out.append('')
+    out.append('#endif /* __KBS_SCANCODE_TBL_H__ */')
+
+    with open(output, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+
+    main(sys.argv[1])
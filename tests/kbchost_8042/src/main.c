@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/espi.h>
+#include <zephyr/ztest.h>
+#include "kbc_emul.h"
+#include "kbchost.h"
+
+/* kbchost waits a few ms before answering, like a PS/2 device does */
+#define HOST_TIMEOUT_MS		100
+/* No response is expected once the port stays empty this long */
+#define HOST_QUIET_MS		20
+
+/* Command byte written by OS i8042 driver, keyboard and mouse enabled */
+#define TEST_CMD_BYTE		(KBC_8042_EN_KBD_IRQ | KBC_8042_EN_MOUSE_IRQ | \
+				 KBC_8042_HOST_SYS_FLAG | KBC_8042_TRANSLATE)
+
+static int host_wait(uint8_t flag, bool set, int timeout_ms)
+{
+	for (int i = 0; i < timeout_ms; i++) {
+		bool sts = kbc_emul_host_read_sts() & flag;
+
+		if (sts == set) {
+			return 0;
+		}
+
+		k_msleep(1);
+	}
+
+	return -ETIMEDOUT;
+}
+
+/* Write to port 0x64 or 0x60 and check the bytes returned on port 0x60 */
+static void host_xfer(bool cmd, uint8_t byte, const uint8_t *resp, int len)
+{
+	uint8_t data;
+	int ret;
+
+	zassert_ok(host_wait(KBC_EMUL_STS_IBF, false, HOST_TIMEOUT_MS),
+		   "Input buffer full");
+	ret = cmd ? kbc_emul_host_write_cmd(byte) :
+		    kbc_emul_host_write_data(byte);
+	zassert_ok(ret, "Write %02x failed", byte);
+
+	for (int i = 0; i < len; i++) {
+		zassert_ok(host_wait(KBC_EMUL_STS_OBF, true, HOST_TIMEOUT_MS),
+			   "No response %d to %02x", i, byte);
+		zassert_ok(kbc_emul_host_read_data(&data), "Read failed");
+		zassert_equal(data, resp[i], "Got %02x to %02x expected %02x",
+			      data, byte, resp[i]);
+	}
+
+	zassert_equal(host_wait(KBC_EMUL_STS_OBF, true, HOST_QUIET_MS),
+		      -ETIMEDOUT, "Unexpected response to %02x", byte);
+}
+
+#define CMD(b, ...)	host_xfer(true, b, (const uint8_t []){ __VA_ARGS__ }, \
+				  sizeof((const uint8_t []){ __VA_ARGS__ }))
+#define CMD_NO_RESP(b)	host_xfer(true, b, NULL, 0)
+#define DATA(b, ...)	host_xfer(false, b, (const uint8_t []){ __VA_ARGS__ }, \
+				  sizeof((const uint8_t []){ __VA_ARGS__ }))
+#define DATA_NO_RESP(b)	host_xfer(false, b, NULL, 0)
+
+static void before(void *fixture)
+{
+	uint8_t data;
+
+	ARG_UNUSED(fixture);
+
+	/* Discard late bytes from a previous test */
+	while (!host_wait(KBC_EMUL_STS_OBF, true, HOST_QUIET_MS)) {
+		kbc_emul_host_read_data(&data);
+	}
+
+	CMD_NO_RESP(KBC_8042_WRITE_CMD_BYTE);
+	DATA_NO_RESP(TEST_CMD_BYTE);
+}
+
+ZTEST(kbchost_8042, test_self_test)
+{
+	CMD(KBC_8042_RESET_SELF_TEST, TEST_PASSED);
+	CMD(KBC_8042_TEST_KB_PORT, 0x00);
+	CMD(KBC_8042_TEST_PASSWORD, NO_PASSWORD);
+}
+
+ZTEST(kbchost_8042, test_cmd_byte)
+{
+	CMD(KBC_8042_READ_CMD_BYTE, TEST_CMD_BYTE);
+	zassert_true(kbc_emul_host_read_sts() & KBC_EMUL_STS_SYS,
+		     "System flag not set");
+
+	CMD_NO_RESP(KBC_8042_DIS_KB);
+	CMD(KBC_8042_READ_CMD_BYTE, TEST_CMD_BYTE | KBC_8042_KBD_DIS);
+	CMD_NO_RESP(KBC_8042_ENA_KB);
+	CMD(KBC_8042_READ_CMD_BYTE, TEST_CMD_BYTE);
+
+	CMD_NO_RESP(KBC_8042_WRITE_CMD_BYTE);
+	DATA_NO_RESP(TEST_CMD_BYTE & ~KBC_8042_HOST_SYS_FLAG);
+	zassert_false(kbc_emul_host_read_sts() & KBC_EMUL_STS_SYS,
+		      "System flag not cleared");
+}
+
+ZTEST(kbchost_8042, test_output_reg)
+{
+	CMD_NO_RESP(KBC_8042_WRITE_KBD_OUTPUT_REG);
+	DATA(0x5a, 0x5a);
+}
+
+ZTEST(kbchost_8042, test_leds)
+{
+	DATA(KBC_8042_SET_LEDS, KBC_8042_ACK);
+	DATA(BIT(NUM_LOCK_POS), KBC_8042_ACK);
+	zassert_equal(kbc_get_leds(), BIT(NUM_LOCK_POS), "Num lock not set");
+
+	DATA(KBC_8042_SET_LEDS, KBC_8042_ACK);
+	DATA(0, KBC_8042_ACK);
+	zassert_equal(kbc_get_leds(), 0, "Leds not cleared");
+}
+
+ZTEST(kbchost_8042, test_typematic)
+{
+	DATA(KBC_8042_SET_TYPEMATIC_RATE, KBC_8042_ACK);
+	DATA(0x20, KBC_8042_ACK);
+}
+
+ZTEST(kbchost_8042, test_scancode)
+{
+	DATA(KBC_8042_SET_GET_SCANCODE, KBC_8042_ACK);
+	DATA(0x01, KBC_8042_ACK);
+	DATA(KBC_8042_SET_GET_SCANCODE, KBC_8042_ACK);
+	DATA(0x00, KBC_8042_ACK, 0x01);
+
+	/* Keyboard reset restores the default set */
+	DATA(KBC_8042_RESET, KBC_8042_ACK, KBC_8042_BAT);
+	DATA(KBC_8042_SET_GET_SCANCODE, KBC_8042_ACK);
+	DATA(0x00, KBC_8042_ACK, KBC_8042_DEFAULT_SCAN_CODE);
+	DATA(KBC_8042_READ_ID, KBC_8042_ACK, 0xab, 0x83);
+}
+
+ZTEST(kbchost_8042, test_reset)
+{
+	DATA(KBC_8042_RESET, KBC_8042_ACK, KBC_8042_BAT);
+	DATA(KBC_8042_EN_KEYBOARD, KBC_8042_ACK);
+	DATA(KBC_8042_ECHO_KEYBOARD, KBC_8042_ECHO_KEYBOARD);
+	/* Resend repeats the last response */
+	DATA(KBC_8042_RESEND, KBC_8042_ECHO_KEYBOARD);
+}
+
+ZTEST(kbchost_8042, test_default_dis)
+{
+	DATA(KBC_8042_DEFAULT_DIS, KBC_8042_ACK);
+	CMD(KBC_8042_READ_CMD_BYTE, TEST_CMD_BYTE | KBC_8042_KBD_DIS);
+	DATA(KBC_8042_EN_KEYBOARD, KBC_8042_ACK);
+}
+
+ZTEST(kbchost_8042, test_unknown)
+{
+	DATA(0x12, KBC_8042_NACK);
+	CMD(0x12, KBC_8042_NACK);
+}
+
+ZTEST(kbchost_8042, test_mouse_absent)
+{
+	/* Without a PS/2 mouse its commands are ignored */
+	CMD_NO_RESP(KBC_8042_DIS_MOUSE);
+	CMD_NO_RESP(KBC_8042_TEST_MOUSE);
+	CMD(KBC_8042_READ_CMD_BYTE, TEST_CMD_BYTE);
+}
+
+ZTEST_SUITE(kbchost_8042, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include "espi_hub.h"
+#include "kbchost.h"
+#include "pwrplane.h"
+#include "smc.h"
+#include "task_handler.h"
+
+/* eSPI hub and power sequencing glue kbchost relies on, only the 8042 KBC
+ * emulator is real so the host interface is exercised as on a board.
+ */
+
+#define KBC_STACK_SIZE	1024
+
+static espi_kbc_handler_t kbc_handler_cb;
+
+K_THREAD_DEFINE(kbc_id, KBC_STACK_SIZE, to_from_host_thread,
+		NULL, NULL, NULL, EC_TASK_PRIORITY, 0, 0);
+K_THREAD_DEFINE(kb_id, KBC_STACK_SIZE, to_host_kb_thread,
+		NULL, NULL, NULL, EC_TASK_PRIORITY, 0, 0);
+
+int espihub_add_kbc_handler(espi_kbc_handler_t handler)
+{
+	if (kbc_handler_cb) {
+		return -EINVAL;
+	}
+
+	kbc_handler_cb = handler;
+
+	return 0;
+}
+
+void espihub_kbc_event(struct espi_evt_data_kbc *kbc)
+{
+	if (kbc_handler_cb) {
+		kbc_handler_cb(kbc);
+	}
+}
+
+enum system_power_state pwrseq_system_state(void)
+{
+	return SYSTEM_S0_STATE;
+}
+
+void smc_generate_wake(uint8_t wake_reason)
+{
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/ztest.h>
+#include "kbs_matrix_ghost.h"
+
+#define ROWS	4U
+
+struct key {
+	uint8_t row;
+	uint8_t col;
+};
+
+/* A and B held from a previous scan, C is pressed and the matrix reports
+ * the phantom key D closing the rectangle.
+ */
+static const struct key key_a = { 0, 0 };
+static const struct key key_b = { 0, 1 };
+static const struct key key_c = { 1, 0 };
+static const struct key key_d = { 1, 1 };
+/* Outside of the rectangle */
+static const struct key key_e = { 2, 3 };
+
+static uint32_t pressed[ROWS];
+static uint32_t fresh[ROWS];
+
+static void press(const struct key *key, bool held)
+{
+	pressed[key->row] |= BIT(key->col);
+	if (!held) {
+		fresh[key->row] |= BIT(key->col);
+	}
+}
+
+static bool kept(const struct key *key)
+{
+	return fresh[key->row] & BIT(key->col);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(pressed, 0, sizeof(pressed));
+	memset(fresh, 0, sizeof(fresh));
+}
+
+ZTEST(kbs_matrix_ghost, test_real_key_first)
+{
+	press(&key_a, true);
+	press(&key_b, true);
+	press(&key_c, false);
+	press(&key_d, false);
+	kbs_matrix_ghost_filter(pressed, fresh, ROWS);
+
+	zassert_false(kept(&key_c), "Real key closing a rectangle kept");
+	zassert_false(kept(&key_d), "Phantom key kept");
+}
+
+ZTEST(kbs_matrix_ghost, test_phantom_key_first)
+{
+	press(&key_a, true);
+	press(&key_b, true);
+	press(&key_d, false);
+	press(&key_c, false);
+	kbs_matrix_ghost_filter(pressed, fresh, ROWS);
+
+	zassert_false(kept(&key_d), "Phantom key kept");
+	zassert_false(kept(&key_c), "Real key closing a rectangle kept");
+}
+
+ZTEST(kbs_matrix_ghost, test_no_rectangle)
+{
+	press(&key_a, true);
+	press(&key_b, false);
+	press(&key_c, false);
+	press(&key_e, false);
+	kbs_matrix_ghost_filter(pressed, fresh, ROWS);
+
+	zassert_true(kept(&key_b), "Key without rectangle dropped");
+	zassert_true(kept(&key_c), "Key without rectangle dropped");
+	zassert_true(kept(&key_e), "Key without rectangle dropped");
+}
+
+ZTEST(kbs_matrix_ghost, test_rectangle_in_one_scan)
+{
+	press(&key_e, false);
+	press(&key_d, false);
+	press(&key_c, false);
+	press(&key_b, false);
+	press(&key_a, false);
+	kbs_matrix_ghost_filter(pressed, fresh, ROWS);
+
+	zassert_false(kept(&key_a), "Key closing a rectangle kept");
+	zassert_false(kept(&key_b), "Key closing a rectangle kept");
+	zassert_false(kept(&key_c), "Key closing a rectangle kept");
+	zassert_false(kept(&key_d), "Key closing a rectangle kept");
+	zassert_true(kept(&key_e), "Key outside of the rectangle dropped");
+}
+
+ZTEST_SUITE(kbs_matrix_ghost, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __TEST_BOARD_CONFIG_H__
+#define __TEST_BOARD_CONFIG_H__
+
+#include "gpio_ec.h"
+
+/* Board signals used by smchost, only written through stubs */
+#define PROCHOT		EC_GPIO_PORT_PIN(0, 0)
+#define WAKE_SCI	EC_GPIO_PORT_PIN(0, 1)
+#define VOL_UP		EC_GPIO_PORT_PIN(0, 2)
+#define VOL_DOWN	EC_GPIO_PORT_PIN(0, 3)
+#define SMC_LID		EC_GPIO_PORT_PIN(0, 4)
+#define HOME_BUTTON	EC_GPIO_PORT_PIN(0, 5)
+
+#endif /* __TEST_BOARD_CONFIG_H__ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include "acpi.h"
+#include "acpi_emul.h"
+#include "host.h"
+
+/* OS EC driver transaction timeout */
+#define HOST_TIMEOUT_MS		100
+
+int host_wait(uint8_t flag, bool set)
+{
+	for (int i = 0; i < HOST_TIMEOUT_MS; i++) {
+		bool sts = acpi_emul_host_read_sts(ACPI_EC_0) & flag;
+
+		if (sts == set) {
+			return 0;
+		}
+
+		k_msleep(1);
+	}
+
+	return -ETIMEDOUT;
+}
+
+int host_cmd(uint8_t cmd)
+{
+	if (host_wait(ACPI_FLAG_IBF, false)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_write_cmd(ACPI_EC_0, cmd);
+}
+
+int host_data(uint8_t data)
+{
+	if (host_wait(ACPI_FLAG_IBF, false)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_write_data(ACPI_EC_0, data);
+}
+
+int host_read(uint8_t *data)
+{
+	if (host_wait(ACPI_FLAG_OBF, true)) {
+		return -ETIMEDOUT;
+	}
+
+	return acpi_emul_host_read_data(ACPI_EC_0, data);
+}
+
+int host_idle(void)
+{
+	int ret;
+
+	ret = host_wait(ACPI_FLAG_IBF, false);
+	/* Let EC FW threads complete the command */
+	k_msleep(1);
+
+	return ret;
+}
+
+void host_drain(void)
+{
+	uint8_t data;
+
+	while (!acpi_emul_host_read_data(ACPI_EC_0, &data)) {
+		k_msleep(1);
+	}
+}
+
+int host_ec_read(uint8_t offset, uint8_t *data)
+{
+	int ret;
+
+	ret = host_cmd(EC_READ);
+	if (!ret) {
+		ret = host_data(offset);
+	}
+
+	if (!ret) {
+		ret = host_read(data);
+	}
+
+	return ret;
+}
+
+int host_ec_write(uint8_t offset, uint8_t data)
+{
+	int ret;
+
+	ret = host_cmd(EC_WRITE);
+	if (!ret) {
+		ret = host_data(offset);
+	}
+
+	if (!ret) {
+		ret = host_data(data);
+	}
+
+	if (!ret) {
+		ret = host_idle();
+	}
+
+	return ret;
+}
+
+int host_ec_query(uint8_t *code)
+{
+	int ret;
+
+	ret = host_cmd(EC_QUERY);
+	if (!ret) {
+		ret = host_read(code);
+	}
+
+	return ret;
+}
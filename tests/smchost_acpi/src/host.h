@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __HOST_H__
+#define __HOST_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Wait until an ACPI EC status flag reaches the expected value.
+ *
+ * Test thread sleeps between polls so EC FW threads get to run.
+ *
+ * @param flag status register flag.
+ * @param set expected value.
+ *
+ * @retval 0 if the flag reached the value, -ETIMEDOUT otherwise.
+ */
+int host_wait(uint8_t flag, bool set);
+
+/**
+ * @brief Write a command byte once input buffer is empty.
+ *
+ * @param cmd the command byte.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_cmd(uint8_t cmd);
+
+/**
+ * @brief Write a data byte once input buffer is empty.
+ *
+ * @param data the data byte.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_data(uint8_t data);
+
+/**
+ * @brief Read a data byte once output buffer is full.
+ *
+ * @param data the data byte read.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_read(uint8_t *data);
+
+/**
+ * @brief Wait until EC consumed all host bytes.
+ *
+ * @retval 0 if success, -ETIMEDOUT otherwise.
+ */
+int host_idle(void);
+
+/**
+ * @brief Discard any byte left in the output buffer.
+ */
+void host_drain(void);
+
+/**
+ * @brief Read an ACPI region offset with EC_READ.
+ *
+ * @param offset ACPI region offset.
+ * @param data the value read.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_ec_read(uint8_t offset, uint8_t *data);
+
+/**
+ * @brief Write an ACPI region offset with EC_WRITE.
+ *
+ * @param offset ACPI region offset.
+ * @param data the value to write.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_ec_write(uint8_t offset, uint8_t data);
+
+/**
+ * @brief Retrieve next SCI code with EC_QUERY.
+ *
+ * @param code the SCI code, 0 if there are no more notifications.
+ *
+ * @retval 0 if success, negative error code otherwise.
+ */
+int host_ec_query(uint8_t *code);
+
+#endif /* __HOST_H__ */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include "espi_hub.h"
+#include "gpio_ec.h"
+#include "led.h"
+#include "periphmgmt.h"
+#include "pwrbtnmgmt.h"
+#include "pwrplane.h"
+#include "smchost.h"
+#include "task_handler.h"
+#include "stubs.h"
+
+/* Hardware and EC FW modules smchost relies on, only the ACPI EC emulator
+ * is real so the host interface is exercised as on a board.
+ */
+
+#define SMCHOST_STACK_SIZE	1024
+
+static uint32_t smchost_period = 10;
+static enum system_power_state pwr_state = SYSTEM_S0_STATE;
+static espi_acpi_handler_t acpi_handler;
+static atomic_t sci_pulses;
+static uint8_t sci_level = ESPIHUB_VW_HIGH;
+
+K_THREAD_DEFINE(smchost_id, SMCHOST_STACK_SIZE, smchost_thread,
+		&smchost_period, NULL, NULL, EC_TASK_PRIORITY, 0, 0);
+
+void stub_set_pwr_state(enum system_power_state state)
+{
+	pwr_state = state;
+}
+
+bool stub_acpi_handler_ready(void)
+{
+	return acpi_handler != NULL;
+}
+
+uint32_t stub_sci_pulses(void)
+{
+	return atomic_get(&sci_pulses);
+}
+
+uint8_t stub_sci_level(void)
+{
+	return sci_level;
+}
+
+enum system_power_state pwrseq_system_state(void)
+{
+	return pwr_state;
+}
+
+int espihub_add_acpi_handler(enum espihub_acpi_handler type,
+			     espi_acpi_handler_t handler)
+{
+	if (type != ESPIHUB_ACPI_PUBLIC || acpi_handler) {
+		return -EINVAL;
+	}
+
+	acpi_handler = handler;
+
+	return 0;
+}
+
+int espihub_add_warn_handler(enum espihub_handler handler_type,
+			     espi_warn_handler_t handler)
+{
+	return 0;
+}
+
+void espihub_acpi_event(void)
+{
+	if (acpi_handler) {
+		acpi_handler();
+	}
+}
+
+int espihub_send_vw(enum espi_vwire_signal signal, uint8_t level)
+{
+	if (signal != ESPI_VWIRE_SIGNAL_SCI) {
+		return 0;
+	}
+
+	if (sci_level == ESPIHUB_VW_HIGH && level == ESPIHUB_VW_LOW) {
+		atomic_inc(&sci_pulses);
+	}
+
+	sci_level = level;
+
+	return 0;
+}
+
+int gpio_write_pin(uint32_t port_pin, int value)
+{
+	return 0;
+}
+
+void led_init(enum led_num idx)
+{
+}
+
+void led_blink(enum led_num idx, uint8_t duty_cycle)
+{
+}
+
+int periph_register_button(uint32_t port_pin, btn_handler_t handler)
+{
+	return 0;
+}
+
+void pwrbtn_register_handler(pwrbtn_handler_t handler)
+{
+}
+
+void update_virtual_bat_dock_status(void)
+{
+}
+
+uint8_t check_btn_sci_sts(uint8_t btn_sci_en_dis)
+{
+	return 0;
+}
+
+void smchost_pwrbtn_handler(uint8_t pwrbtn_sts)
+{
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __STUBS_H__
+#define __STUBS_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "system.h"
+
+/**
+ * @brief Set the power state reported to smchost.
+ *
+ * @param state system power state.
+ */
+void stub_set_pwr_state(enum system_power_state state);
+
+/**
+ * @brief Check if smchost registered its ACPI EC handler.
+ *
+ * @retval true once smchost task is ready to serve the host.
+ */
+bool stub_acpi_handler_ready(void);
+
+/**
+ * @brief Get the number of SCI pulses started.
+ *
+ * @retval number of falling edges of the SCI virtual wire.
+ */
+uint32_t stub_sci_pulses(void);
+
+/**
+ * @brief Get the SCI virtual wire level.
+ *
+ * @retval last level sent for the SCI virtual wire.
+ */
+uint8_t stub_sci_level(void);
+
+#endif /* __STUBS_H__ */
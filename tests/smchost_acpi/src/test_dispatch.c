@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "acpi.h"
+#include "acpi_emul.h"
+#include "acpi_region.h"
+#include "scicodes.h"
+#include "smc.h"
+#include "smchost.h"
+#include "smchost_commands.h"
+#include "host.h"
+#include "stubs.h"
+
+/* Commands registered by the test, codes are not used by EC FW */
+#define TEST_CMD_S0		0xE0
+#define TEST_CMD_ACPI_MODE	0xE1
+#define TEST_CMD_UNKNOWN	0xE2
+
+#define TEST_BLOCK_LEN		4u
+#define TEST_RW_OFFSET		offsetof(struct acpi_tbl, acpi_smb.data)
+#define TEST_RO_OFFSET		offsetof(struct acpi_tbl, acpi_space)
+#define TEST_SUB_OFFSET		offsetof(struct acpi_tbl, acpi_smb.cmd)
+
+static atomic_t s0_calls;
+static atomic_t acpi_mode_calls;
+static K_SEM_DEFINE(sub_sem, 0, 1);
+
+static void test_cmd_s0(void)
+{
+	atomic_inc(&s0_calls);
+}
+
+static void test_cmd_acpi_mode(void)
+{
+	atomic_inc(&acpi_mode_calls);
+}
+
+static void test_sub_handler(uint8_t offset)
+{
+	k_sem_give(&sub_sem);
+}
+
+SMCHOST_CMD_DEFINE(TEST_CMD_S0, 0, SMCHOST_CMD_PWR_S0, 0, test_cmd_s0);
+SMCHOST_CMD_DEFINE(TEST_CMD_ACPI_MODE, 0, SMCHOST_CMD_PWR_ANY,
+		   SMCHOST_CMD_FLAG_ACPI_MODE, test_cmd_acpi_mode);
+SMC_ACPI_SUBSCRIBE(test_sub, acpi_smb.cmd, test_sub_handler);
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_true(stub_acpi_handler_ready(), "smchost not ready");
+	stub_set_pwr_state(SYSTEM_S0_STATE);
+	zassert_ok(host_cmd(SMCHOST_DISABLE_ACPI), "Disable ACPI failed");
+	zassert_ok(host_idle(), "EC busy");
+	host_drain();
+	atomic_clear(&s0_calls);
+	atomic_clear(&acpi_mode_calls);
+	k_sem_reset(&sub_sem);
+}
+
+ZTEST(smchost_dispatch, test_ec_read)
+{
+	uint8_t data;
+
+	g_acpi_tbl.acpi_remote_temp = 0x42;
+	zassert_ok(host_ec_read(offsetof(struct acpi_tbl, acpi_remote_temp),
+				&data), "EC_READ failed");
+	zassert_equal(data, 0x42, "Wrong EC_READ data %02x", data);
+}
+
+ZTEST(smchost_dispatch, test_ec_write)
+{
+	uint8_t *acpi = (uint8_t *)&g_acpi_tbl;
+
+	zassert_ok(host_ec_write(TEST_RW_OFFSET, 0x5A), "EC_WRITE failed");
+	zassert_equal(acpi[TEST_RW_OFFSET], 0x5A, "Writable offset unchanged");
+
+	acpi[TEST_RO_OFFSET] = 0;
+	zassert_ok(host_ec_write(TEST_RO_OFFSET, 0x77), "EC_WRITE failed");
+	zassert_equal(acpi[TEST_RO_OFFSET], 0, "Read-only offset written");
+}
+
+ZTEST(smchost_dispatch, test_unknown_cmd)
+{
+	uint8_t data;
+
+	zassert_ok(host_cmd(TEST_CMD_UNKNOWN), "Command not accepted");
+	zassert_ok(host_data(0x12), "Data not accepted");
+	zassert_ok(host_data(0x34), "Data not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_false(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_OBF,
+		      "Unknown command answered");
+
+	/* Discarded data is not taken as a new transaction */
+	g_acpi_tbl.acpi_remote_temp = 0x24;
+	zassert_ok(host_ec_read(offsetof(struct acpi_tbl, acpi_remote_temp),
+				&data), "EC_READ failed");
+	zassert_equal(data, 0x24, "Wrong EC_READ data %02x", data);
+}
+
+ZTEST(smchost_dispatch, test_burst)
+{
+	uint8_t ack;
+
+	zassert_ok(host_cmd(EC_BURST), "Burst enable failed");
+	zassert_ok(host_read(&ack), "No burst ack");
+	zassert_equal(ack, SCI_BURST_ACK, "Wrong burst ack %02x", ack);
+	zassert_true(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_ACPIBURST,
+		     "Burst flag not set");
+
+	zassert_ok(host_cmd(EC_NORM), "Burst disable failed");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_false(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_ACPIBURST,
+		      "Burst flag not cleared");
+}
+
+ZTEST(smchost_dispatch, test_cmd_pwr_state)
+{
+	stub_set_pwr_state(SYSTEM_S5_STATE);
+	zassert_ok(host_cmd(TEST_CMD_S0), "Command not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_equal(atomic_get(&s0_calls), 0, "S0 command run in S5");
+
+	stub_set_pwr_state(SYSTEM_S0_STATE);
+	zassert_ok(host_cmd(TEST_CMD_S0), "Command not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_equal(atomic_get(&s0_calls), 1, "S0 command not run in S0");
+}
+
+ZTEST(smchost_dispatch, test_cmd_acpi_mode)
+{
+	zassert_ok(host_cmd(TEST_CMD_ACPI_MODE), "Command not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_equal(atomic_get(&acpi_mode_calls), 0,
+		      "ACPI mode command run outside ACPI mode");
+
+	zassert_ok(host_cmd(SMCHOST_ENABLE_ACPI), "Enable ACPI failed");
+	zassert_ok(host_cmd(TEST_CMD_ACPI_MODE), "Command not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_equal(atomic_get(&acpi_mode_calls), 1,
+		      "ACPI mode command not run in ACPI mode");
+}
+
+ZTEST(smchost_dispatch, test_acpi_block)
+{
+	const uint8_t wr[TEST_BLOCK_LEN] = { 0x11, 0x22, 0x33, 0x44 };
+	uint8_t rd[TEST_BLOCK_LEN];
+	uint8_t sts;
+
+	zassert_ok(host_cmd(SMCHOST_WRITE_ACPI_BLOCK), "Command not accepted");
+	zassert_ok(host_data(TEST_RW_OFFSET), "Data not accepted");
+	zassert_ok(host_data(TEST_BLOCK_LEN), "Data not accepted");
+	for (int i = 0; i < TEST_BLOCK_LEN; i++) {
+		zassert_ok(host_data(wr[i]), "Data not accepted");
+	}
+
+	zassert_ok(host_read(&sts), "No write block status");
+	zassert_equal(sts, SMCHOST_ACPI_BLOCK_OK, "Write block failed");
+
+	zassert_ok(host_cmd(SMCHOST_READ_ACPI_BLOCK), "Command not accepted");
+	zassert_ok(host_data(TEST_RW_OFFSET), "Data not accepted");
+	zassert_ok(host_data(TEST_BLOCK_LEN), "Data not accepted");
+	zassert_ok(host_read(&sts), "No read block status");
+	zassert_equal(sts, SMCHOST_ACPI_BLOCK_OK, "Read block failed");
+	for (int i = 0; i < TEST_BLOCK_LEN; i++) {
+		zassert_ok(host_read(&rd[i]), "Read block data missing");
+	}
+
+	zassert_mem_equal(rd, wr, TEST_BLOCK_LEN, "Read block mismatch");
+}
+
+ZTEST(smchost_dispatch, test_acpi_block_invalid)
+{
+	uint8_t sts;
+
+	/* Byte count exceeding the buffer is answered right away */
+	zassert_ok(host_cmd(SMCHOST_WRITE_ACPI_BLOCK), "Command not accepted");
+	zassert_ok(host_data(TEST_RW_OFFSET), "Data not accepted");
+	zassert_ok(host_data(SMCHOST_ACPI_BLOCK_MAX + 1), "Data not accepted");
+	zassert_ok(host_read(&sts), "No write block status");
+	zassert_equal(sts, SMCHOST_ACPI_BLOCK_INVALID, "Overflow accepted");
+
+	/* Data sent anyway by the host is discarded */
+	zassert_ok(host_data(0x55), "Data not accepted");
+	zassert_ok(host_idle(), "EC busy");
+	zassert_false(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_OBF,
+		      "Discarded data answered");
+
+	zassert_ok(host_cmd(SMCHOST_WRITE_ACPI_BLOCK), "Command not accepted");
+	zassert_ok(host_data(TEST_RO_OFFSET), "Data not accepted");
+	zassert_ok(host_data(1), "Data not accepted");
+	zassert_ok(host_data(0x55), "Data not accepted");
+	zassert_ok(host_read(&sts), "No write block status");
+	zassert_equal(sts, SMCHOST_ACPI_BLOCK_DENIED, "Read-only written");
+}
+
+ZTEST(smchost_dispatch, test_acpi_subscriber)
+{
+	zassert_ok(host_ec_write(TEST_SUB_OFFSET, 0x01), "EC_WRITE failed");
+	zassert_ok(k_sem_take(&sub_sem, K_MSEC(100)),
+		   "Subscriber not notified");
+}
+
+ZTEST_SUITE(smchost_dispatch, NULL, NULL, before, NULL, NULL);
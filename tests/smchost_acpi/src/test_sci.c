@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include "acpi.h"
+#include "acpi_emul.h"
+#include "espi_hub.h"
+#include "sci.h"
+#include "scicodes.h"
+#include "smchost_commands.h"
+#include "host.h"
+#include "stubs.h"
+
+/* Time allowed for smchost task to signal and complete an SCI pulse */
+#define SCI_TIMEOUT_MS		100
+
+static struct sci_stats stats;
+
+static void sci_expect(const uint8_t *codes, int count)
+{
+	uint8_t code;
+
+	for (int i = 0; i < count; i++) {
+		zassert_ok(host_ec_query(&code), "Query failed");
+		zassert_equal(code, codes[i], "Got SCI %02x expected %02x",
+			      code, codes[i]);
+	}
+
+	zassert_ok(host_ec_query(&code), "Query failed");
+	zassert_equal(code, 0, "Unexpected SCI %02x", code);
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_true(stub_acpi_handler_ready(), "smchost not ready");
+	stub_set_pwr_state(SYSTEM_S0_STATE);
+	zassert_ok(host_cmd(SMCHOST_ENABLE_ACPI), "Enable ACPI failed");
+	zassert_ok(host_idle(), "EC busy");
+	host_drain();
+	sci_queue_flush();
+	sci_get_stats(&stats);
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(host_cmd(SMCHOST_DISABLE_ACPI), "Disable ACPI failed");
+	zassert_ok(host_idle(), "EC busy");
+}
+
+ZTEST(smchost_sci, test_query_empty)
+{
+	sci_expect(NULL, 0);
+	zassert_false(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_SCIEVENT,
+		      "SCI event flag set without notifications");
+}
+
+ZTEST(smchost_sci, test_pulse)
+{
+	struct sci_stats now;
+	uint32_t pulses = stub_sci_pulses();
+	int i;
+
+	enqueue_sci(SCI_VB);
+	for (i = 0; i < SCI_TIMEOUT_MS; i++) {
+		if (stub_sci_pulses() > pulses &&
+		    stub_sci_level() == ESPIHUB_VW_HIGH) {
+			break;
+		}
+
+		k_msleep(1);
+	}
+
+	zassert_true(i < SCI_TIMEOUT_MS, "SCI pulse not completed");
+	zassert_true(acpi_emul_host_read_sts(ACPI_EC_0) & ACPI_FLAG_SCIEVENT,
+		     "SCI event flag not set");
+	sci_get_stats(&now);
+	zassert_true(now.pulses > stats.pulses, "SCI pulse not counted");
+
+	sci_expect((const uint8_t []){ SCI_VB }, 1);
+}
+
+ZTEST(smchost_sci, test_critical_first)
+{
+	enqueue_sci(SCI_VB);
+	enqueue_sci(SCI_HOTKEY);
+	enqueue_sci(SCI_LID);
+
+	sci_expect((const uint8_t []){ SCI_LID, SCI_VB, SCI_HOTKEY }, 3);
+}
+
+ZTEST(smchost_sci, test_merge)
+{
+	struct sci_stats now;
+
+	enqueue_sci(SCI_LID);
+	enqueue_sci(SCI_LID);
+	sci_get_stats(&now);
+	zassert_equal(now.merged - stats.merged, 1, "Status SCI not merged");
+	zassert_equal(now.queued - stats.queued, 1, "Status SCI queued twice");
+
+	sci_expect((const uint8_t []){ SCI_LID }, 1);
+}
+
+ZTEST(smchost_sci, test_button_debounce)
+{
+	struct sci_stats now;
+
+	enqueue_sci(SCI_VU_PRES);
+	enqueue_sci(SCI_VU_REL);
+	/* Chatter is dropped along with its release */
+	enqueue_sci(SCI_VU_PRES);
+	enqueue_sci(SCI_VU_REL);
+	sci_get_stats(&now);
+	zassert_equal(now.debounced - stats.debounced, 2,
+		      "Chatter not dropped");
+
+	sci_expect((const uint8_t []){ SCI_VU_PRES, SCI_VU_REL }, 2);
+}
+
+ZTEST(smchost_sci, test_rate_limit)
+{
+	enqueue_sci(SCI_BATTERY);
+	sci_expect((const uint8_t []){ SCI_BATTERY }, 1);
+
+	/* Held until holdoff time elapses */
+	enqueue_sci(SCI_BATTERY);
+	sci_expect(NULL, 0);
+
+	k_msleep(CONFIG_SMCHOST_SCI_HOLDOFF_MS);
+	sci_expect((const uint8_t []){ SCI_BATTERY }, 1);
+}
+
+ZTEST(smchost_sci, test_not_queued)
+{
+	struct sci_stats now;
+
+	stub_set_pwr_state(SYSTEM_S5_STATE);
+	enqueue_sci(SCI_LID);
+	stub_set_pwr_state(SYSTEM_S0_STATE);
+
+	zassert_ok(host_cmd(SMCHOST_DISABLE_ACPI), "Disable ACPI failed");
+	zassert_ok(host_idle(), "EC busy");
+	enqueue_sci(SCI_LID);
+
+	sci_get_stats(&now);
+	zassert_equal(now.queued, stats.queued, "SCI queued");
+}
+
+ZTEST_SUITE(smchost_sci, NULL, NULL, before, after, NULL);